@@ -30,12 +30,15 @@
 #include "thread.h"
 #include "vcode.h"
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <unistd.h>
 #include <ctype.h>
 #include <libgen.h>
+#include <dirent.h>
+#include <utime.h>
 #include <sys/stat.h>
 
 #include <llvm-c/Core.h>
@@ -48,9 +51,18 @@
 #include <llvm-c/Transforms/PassManagerBuilder.h>
 #include <llvm-c/TargetMachine.h>
 
+#if HAVE_GIT_SHA
+#include "gitsha.h"
+#define GIT_SHA_ONLY(x) x
+#else
+#define GIT_SHA_ONLY(x)
+#endif
+
 #define DEBUG_METADATA_VERSION 3
 #define CONST_REP_ARRAY_LIMIT  32
 #define UNITS_PER_JOB          25
+#define CODE_CACHE_DIR         "_NVC_CACHE"
+#define CODE_CACHE_MAX         1000
 
 #define DUMP_ASSEMBLY 0
 #define DUMP_BITCODE  0
@@ -85,7 +97,20 @@ typedef enum {
 } func_attr_t;
 
 typedef A(vcode_unit_t) unit_list_t;
-typedef A(char *) obj_list_t;
+
+typedef struct {
+   char *path;    // Object file passed to the linker
+   char *cache;   // Location in code cache or NULL
+} cgen_obj_t;
+
+typedef A(cgen_obj_t) obj_list_t;
+
+typedef struct {
+   char   *path;
+   time_t  mtime;
+} cache_entry_t;
+
+typedef A(cache_entry_t) cache_list_t;
 
 typedef struct {
    unit_list_t      units;
@@ -803,6 +828,21 @@ static LLVMValueRef cgen_mspace_alloc(LLVMValueRef bytes, LLVMValueRef nelems,
    return LLVMBuildPointerCast(builder, raw, LLVMPointerType(type, 0), "");
 }
 
+static LLVMValueRef cgen_tlab_global(void)
+{
+   LLVMValueRef global = LLVMGetNamedGlobal(module, "__nvc_tlab");
+   if (global == NULL) {
+      global = LLVMAddGlobal(module, llvm_tlab_type(), "__nvc_tlab");
+      LLVMSetLinkage(global, LLVMExternalLinkage);
+#ifndef __MINGW32__
+      // Each thread running processes has its own TLAB
+      LLVMSetThreadLocalMode(global, LLVMInitialExecTLSModel);
+#endif
+   }
+
+   return global;
+}
+
 static LLVMValueRef cgen_tlab_alloc(LLVMValueRef bytes, LLVMTypeRef type)
 {
    LLVMValueRef fn = LLVMGetNamedFunction(module, "tlab_alloc");
@@ -818,12 +858,7 @@ static LLVMValueRef cgen_tlab_alloc(LLVMValueRef bytes, LLVMTypeRef type)
       LLVMPositionBuilderAtEnd(builder, entry_bb);
 
       LLVMTypeRef tlab_type = llvm_tlab_type();
-
-      LLVMValueRef global = LLVMGetNamedGlobal(module, "__nvc_tlab");
-      if (global == NULL) {
-         global = LLVMAddGlobal(module, tlab_type, "__nvc_tlab");
-         LLVMSetLinkage(global, LLVMExternalLinkage);
-      }
+      LLVMValueRef global = cgen_tlab_global();
 
       LLVMValueRef alloc_ptr =
          LLVMBuildStructGEP2(builder, tlab_type, global, 2, "");
@@ -881,12 +916,7 @@ static LLVMValueRef cgen_tlab_alloc(LLVMValueRef bytes, LLVMTypeRef type)
 static LLVMValueRef cgen_tlab_watermark(void)
 {
    LLVMTypeRef tlab_type = llvm_tlab_type();
-
-   LLVMValueRef global = LLVMGetNamedGlobal(module, "__nvc_tlab");
-   if (global == NULL) {
-      global = LLVMAddGlobal(module, tlab_type, "__nvc_tlab");
-      LLVMSetLinkage(global, LLVMExternalLinkage);
-   }
+   LLVMValueRef global = cgen_tlab_global();
 
    LLVMValueRef alloc_ptr =
       LLVMBuildStructGEP2(builder, tlab_type, global, 2, "");
@@ -4535,6 +4565,45 @@ static void cgen_find_units(vcode_unit_t root, unit_list_t *units)
       cgen_find_dependencies(units->items[i], units);
 }
 
+static char *cgen_cache_path(const unit_list_t *units, unsigned first,
+                             unsigned count, const char *module_name,
+                             tree_t top)
+{
+   // Object files are content addressed by the vcode of each unit in
+   // the job along with everything else that affects code generation
+
+   static char *target = NULL;
+   if (target == NULL) {
+      char *triple = LLVMGetDefaultTargetTriple();
+      char *cpu = LLVMGetHostCPUName();
+      target = xasprintf("%s %s", triple, cpu);
+      LLVMDisposeMessage(triple);
+      LLVMDisposeMessage(cpu);
+   }
+
+   LOCAL_TEXT_BUF tb = tb_new();
+   tb_printf(tb, PACKAGE_STRING GIT_SHA_ONLY(" " GIT_SHA)
+             DEBUG_ONLY(" " __DATE__ " " __TIME__)
+             " LLVM " LLVM_VERSION " ABI %d %s -O%d %s %s %u",
+             RT_ABI_VERSION, target, opt_get_int(OPT_OPTIMISE),
+             module_name, loc_file_str(tree_loc(top)), first == 0);
+
+   for (unsigned i = first; i < first + count; i++)
+      tb_printf(tb, " %"PRIx64, vcode_unit_hash(units->items[i]));
+
+   uint64_t hash = UINT64_C(0xcbf29ce484222325);
+   for (const char *p = tb_get(tb); *p; p++)
+      hash = (hash ^ (uint8_t)*p) * UINT64_C(0x100000001b3);
+
+   char *name LOCAL =
+      xasprintf(CODE_CACHE_DIR DIR_SEP "%016"PRIx64"." LLVM_OBJ_EXT, hash);
+
+   char path[PATH_MAX];
+   lib_realpath(lib_work(), name, path, sizeof(path));
+
+   return xstrdup(path);
+}
+
 static void cgen_partition_jobs(unit_list_t *units, workq_t *wq,
                                 const char *base_name, int units_per_job,
                                 tree_t top, cover_tagging_t *cover,
@@ -4542,6 +4611,16 @@ static void cgen_partition_jobs(unit_list_t *units, workq_t *wq,
 {
    int counter = 0;
 
+   // The code cache is not used if the output depends on anything
+   // other than the vcode or would not be saved anyway
+   const bool use_cache = cover == NULL && !opt_get_int(OPT_NO_SAVE)
+      && !opt_get_int(OPT_DUMP_LLVM) && getenv("NVC_CGEN_VERBOSE") == NULL;
+
+   if (use_cache)
+      lib_mkdir(lib_work(), CODE_CACHE_DIR);
+
+   unsigned hits = 0;
+
    // Adjust units_per_job to ensure that each job has a roughly equal
    // number of units
    const int njobs = (units->count + units_per_job - 1) / units_per_job;
@@ -4549,6 +4628,25 @@ static void cgen_partition_jobs(unit_list_t *units, workq_t *wq,
 
    for (unsigned i = 0; i < units->count; i += units_per_job, counter++) {
       char *module_name = xasprintf("%s.%d", base_name, counter);
+      const unsigned count = MIN(units_per_job, units->count - i);
+
+      char *cache_path = NULL;
+      if (use_cache) {
+         cache_path = cgen_cache_path(units, i, count, module_name, top);
+
+         if (access(cache_path, R_OK) == 0) {
+            // Update the modification time so that recently used
+            // objects are the last to be evicted
+            utime(cache_path, NULL);
+
+            const cgen_obj_t obj = { cache_path, cache_path };
+            APUSH(*objs, obj);
+            free(module_name);
+            hits++;
+            continue;
+         }
+      }
+
       char *obj_name LOCAL =
          xasprintf("_%s.%d." LLVM_OBJ_EXT, module_name, getpid());
 
@@ -4562,13 +4660,92 @@ static void cgen_partition_jobs(unit_list_t *units, workq_t *wq,
       job->top         = top;
       job->cover       = cover;
 
-      for (unsigned j = i; j < units->count && j < i + units_per_job; j++)
+      for (unsigned j = i; j < i + count; j++)
          APUSH(job->units, units->items[j]);
 
-      APUSH(*objs, job->obj_path);
+      const cgen_obj_t obj = { job->obj_path, cache_path };
+      APUSH(*objs, obj);
 
       workq_do(wq, cgen_async_work, job);
    }
+
+   if (use_cache)
+      progress("code cache has %u of %u objects", hits, counter);
+}
+
+static int cgen_cache_entry_cmp(const void *a, const void *b)
+{
+   const cache_entry_t *ea = a, *eb = b;
+   if (ea->mtime != eb->mtime)
+      return ea->mtime < eb->mtime ? -1 : 1;
+   else
+      return strcmp(ea->path, eb->path);
+}
+
+static void cgen_evict_cache(const obj_list_t *objs)
+{
+   // Remove the least recently used objects once the code cache grows
+   // beyond the limit, never evicting objects from the current design
+
+   long long limit = CODE_CACHE_MAX;
+   const char *env = getenv("NVC_CACHE_MAX");
+   if (env != NULL) {
+      char *eptr = NULL;
+      const long long value = strtoll(env, &eptr, 10);
+      if (*env == '\0' || *eptr != '\0' || value <= 0)
+         warnf("ignoring invalid NVC_CACHE_MAX value '%s'; the limit must "
+               "be a positive integer", env);
+      else
+         limit = value;
+   }
+
+   char dir[PATH_MAX];
+   lib_realpath(lib_work(), CODE_CACHE_DIR, dir, sizeof(dir));
+
+   DIR *d = opendir(dir);
+   if (d == NULL)
+      return;
+
+   cache_list_t entries = AINIT;
+   int total = 0;
+
+   struct dirent *e;
+   while ((e = readdir(d))) {
+      const char *ext = strrchr(e->d_name, '.');
+      if (ext == NULL || strcmp(ext + 1, LLVM_OBJ_EXT) != 0)
+         continue;
+
+      total++;
+
+      char *path = xasprintf("%s" DIR_SEP "%s", dir, e->d_name);
+
+      bool in_use = false;
+      for (int i = 0; i < objs->count && !in_use; i++)
+         in_use = objs->items[i].cache != NULL
+            && strcmp(objs->items[i].cache, path) == 0;
+
+      struct stat st;
+      if (in_use || stat(path, &st) != 0) {
+         free(path);
+         continue;
+      }
+
+      const cache_entry_t entry = { path, st.st_mtime };
+      APUSH(entries, entry);
+   }
+
+   closedir(d);
+
+   qsort(entries.items, entries.count, sizeof(cache_entry_t),
+         cgen_cache_entry_cmp);
+
+   for (int i = 0; i < entries.count; i++) {
+      // Ignore errors as another process may have removed it already
+      if (total > limit && remove(entries.items[i].path) == 0)
+         total--;
+      free(entries.items[i].path);
+   }
+   ACLEAR(entries);
 }
 
 static void cgen_dump_module(const char *tag)
@@ -5261,7 +5438,7 @@ static void cleanup_temp_dll(void)
    ACLEAR(cleanup_files);
 }
 
-static void cgen_link(const char *module_name, char **objs, int nobjs)
+static void cgen_link(const char *module_name, obj_list_t *objs)
 {
 #ifdef LINKER_PATH
    cgen_link_arg("%s", LINKER_PATH);
@@ -5300,8 +5477,8 @@ static void cgen_link(const char *module_name, char **objs, int nobjs)
    cgen_link_arg("-o");
    cgen_link_arg("%s", so_path);
 
-   for (int i = 0; i < nobjs; i++)
-      cgen_link_arg("%s", objs[i]);
+   for (int i = 0; i < objs->count; i++)
+      cgen_link_arg("%s", objs->items[i].path);
 
 #if defined LINKER_PATH && defined __OpenBSD__
    // Extra linker arguments to make constructors work on OpenBSD
@@ -5325,11 +5502,21 @@ static void cgen_link(const char *module_name, char **objs, int nobjs)
 
    run_program((const char * const *)link_args.items);
 
-   for (int i = 0; i < nobjs ; i++) {
-      if (unlink(objs[i]) != 0)
-         fatal_errno("unlink: %s", objs[i]);
+   bool use_cache = false;
+   for (int i = 0; i < objs->count; i++) {
+      cgen_obj_t *obj = &(objs->items[i]);
+      use_cache |= (obj->cache != NULL);
+      if (obj->cache == obj->path)
+         continue;   // Linked directly from the code cache
+      else if (obj->cache != NULL && rename(obj->path, obj->cache) == 0)
+         continue;   // Saved in the code cache for next time
+      else if (unlink(obj->path) != 0)
+         fatal_errno("unlink: %s", obj->path);
    }
 
+   if (use_cache)
+      cgen_evict_cache(objs);
+
    progress("linking shared library");
 
    for (size_t i = 0; i < link_args.count; i++)
@@ -5528,10 +5715,13 @@ void cgen(tree_t top, vcode_unit_t vcode, cover_tagging_t *cover)
 
    progress("code generation for %d units", units.count);
 
-   cgen_link(istr(name), objs.items, objs.count);
+   cgen_link(istr(name), &objs);
 
-   for (unsigned i = 0; i < objs.count; i++)
-      free(objs.items[i]);
+   for (unsigned i = 0; i < objs.count; i++) {
+      if (objs.items[i].cache != objs.items[i].path)
+         free(objs.items[i].cache);
+      free(objs.items[i].path);
+   }
    ACLEAR(objs);
 
    ACLEAR(units);
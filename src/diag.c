@@ -20,6 +20,7 @@
 #include "diag.h"
 #include "fbuf.h"
 #include "opt.h"
+#include "thread.h"
 
 #include <ctype.h>
 #include <string.h>
@@ -818,61 +819,68 @@ void diag_femit(diag_t *d, FILE *f)
 {
    if (d->suppress)
       return;
-   else if (consumer != NULL && d->level > DIAG_DEBUG)
+
+   if (consumer != NULL && d->level > DIAG_DEBUG)
       (*consumer)(d);
-   else if (get_message_style() == MESSAGE_COMPACT) {
-      if (d->hints.count > 0) {
-         loc_t *loc = &(d->hints.items[0].loc);
-         if (!loc_invalid_p(loc)) {
-            loc_file_t *file_data = loc_file_data(loc);
-            fprintf(f, "%s:%d:%d: ", file_data->name_str, loc->first_line,
-                    loc->first_column + 1);
+   else {
+      // Diagnostics may be emitted concurrently by multiple threads
+      static nvc_lock_t lock = 0;
+      SCOPED_LOCK(lock);
+
+      if (get_message_style() == MESSAGE_COMPACT) {
+         if (d->hints.count > 0) {
+            loc_t *loc = &(d->hints.items[0].loc);
+            if (!loc_invalid_p(loc)) {
+               loc_file_t *file_data = loc_file_data(loc);
+               fprintf(f, "%s:%d:%d: ", file_data->name_str, loc->first_line,
+                       loc->first_column + 1);
+            }
          }
-      }
-
-      switch (d->level) {
-      case DIAG_DEBUG: fprintf(f, "debug: "); break;
-      case DIAG_NOTE:  fprintf(f, "note: "); break;
-      case DIAG_WARN:  fprintf(f, "warning: "); break;
-      case DIAG_ERROR: fprintf(f, "error: "); break;
-      case DIAG_FATAL: fprintf(f, "fatal: "); break;
-      }
 
-      fprintf(f, "%s\n", tb_get(d->msg));
-   }
-   else {
-      if (tb_len(d->msg) > 0) {
-         int col = 0;
          switch (d->level) {
-         case DIAG_DEBUG: col = color_fprintf(f, DEBUG_PREFIX); break;
-         case DIAG_NOTE:  col = color_fprintf(f, NOTE_PREFIX); break;
-         case DIAG_WARN:  col = color_fprintf(f, WARNING_PREFIX); break;
-         case DIAG_ERROR: col = color_fprintf(f, ERROR_PREFIX); break;
-         case DIAG_FATAL: col = color_fprintf(f, FATAL_PREFIX); break;
+         case DIAG_DEBUG: fprintf(f, "debug: "); break;
+         case DIAG_NOTE:  fprintf(f, "note: "); break;
+         case DIAG_WARN:  fprintf(f, "warning: "); break;
+         case DIAG_ERROR: fprintf(f, "error: "); break;
+         case DIAG_FATAL: fprintf(f, "fatal: "); break;
          }
 
-         diag_paginate(tb_get(d->msg), col, f);
-         fputc('\n', f);
+         fprintf(f, "%s\n", tb_get(d->msg));
       }
+      else {
+         if (tb_len(d->msg) > 0) {
+            int col = 0;
+            switch (d->level) {
+            case DIAG_DEBUG: col = color_fprintf(f, DEBUG_PREFIX); break;
+            case DIAG_NOTE:  col = color_fprintf(f, NOTE_PREFIX); break;
+            case DIAG_WARN:  col = color_fprintf(f, WARNING_PREFIX); break;
+            case DIAG_ERROR: col = color_fprintf(f, ERROR_PREFIX); break;
+            case DIAG_FATAL: col = color_fprintf(f, FATAL_PREFIX); break;
+            }
 
-      if (d->hints.count > 0)
-         diag_emit_hints(d, f);
+            diag_paginate(tb_get(d->msg), col, f);
+            fputc('\n', f);
+         }
+
+         if (d->hints.count > 0)
+            diag_emit_hints(d, f);
 
-      if (d->trace.count > 0)
-         diag_emit_trace(d, f);
+         if (d->trace.count > 0)
+            diag_emit_trace(d, f);
 
 #if TRAILING_BLANK
-      if (d->trace.count > 0 || d->hints.count > 0)
-         fputc('\n', f);
+         if (d->trace.count > 0 || d->hints.count > 0)
+            fputc('\n', f);
 #endif
 
-      fflush(f);
+         fflush(f);
+      }
    }
 
    const bool is_error = d->level >= DIAG_ERROR
       || (opt_get_int(OPT_UNIT_TEST) && d->level > DIAG_DEBUG);
 
-   if (is_error && ++n_errors == opt_get_int(OPT_ERROR_LIMIT))
+   if (is_error && atomic_add(&n_errors, 1) == opt_get_int(OPT_ERROR_LIMIT))
       fatal("too many errors, giving up");
 
    for (int i = 0; i < d->hints.count; i++)
@@ -51,6 +51,8 @@
 
 typedef A(jit_func_t *) func_array_t;
 
+#define COMPILE_QUEUE_SIZE 64
+
 typedef struct _jit_tier {
    jit_tier_t    *next;
    int            threshold;
@@ -58,6 +60,27 @@ typedef struct _jit_tier {
    void          *context;
 } jit_tier_t;
 
+typedef struct {
+   jit_func_t *func;
+   jit_tier_t *tier;
+   uint64_t    enqueued;
+} compile_req_t;
+
+typedef struct {
+   nvc_lock_t     lock;
+   nvc_thread_t  *thread;
+   nvc_sema_t     pending;
+   int            stop;
+   unsigned       rptr;
+   unsigned       wptr;
+   compile_req_t  reqs[COMPILE_QUEUE_SIZE];
+   unsigned       compiled;
+   unsigned       deferred;
+   uint64_t       total_wait;
+   uint64_t       max_wait;
+   uint64_t       total_cgen;
+} compile_queue_t;
+
 typedef struct _jit {
    func_array_t    funcs;
    hash_t         *index;
@@ -67,10 +90,13 @@ typedef struct _jit {
    hash_t         *layouts;
    bool            silent;
    bool            runtime;
+   bool            threaded;
    unsigned        backedge;
    int             exit_status;
    jit_tier_t     *tiers;
    jit_dll_t      *aotlib;
+   A(jit_func_t **) retired;
+   compile_queue_t *compileq;
 } jit_t;
 
 typedef enum {
@@ -117,6 +143,7 @@ jit_t *jit_new(void)
    jit_t *j = xcalloc(sizeof(jit_t));
    j->index = hash_new(256);
    j->mspace = mspace_new(opt_get_int(OPT_HEAP_SIZE));
+   j->threaded = true;
 
    mspace_set_oom_handler(j->mspace, jit_oom_cb);
 
@@ -131,13 +158,37 @@ static void jit_free_func(jit_func_t *f)
    jit_free_cfg(f);
    mptr_free(f->jit->mspace, &(f->privdata));
    free(f->irbuf);
+   free(f->threaded);
    free(f->varoff);
    free(f->cpool);
    free(f);
 }
 
+static void jit_stop_compiler(jit_t *j)
+{
+   compile_queue_t *cq = j->compileq;
+
+   // Any requests still waiting in the queue are discarded
+   atomic_store(&cq->stop, 1);
+   nvc_sema_post(&cq->pending);
+   thread_join(cq->thread);
+
+   if (opt_get_int(OPT_RT_STATS) && cq->compiled > 0)
+      notef("JIT compiled %u functions in the background; queue wait "
+            "mean:%"PRIu64"us max:%"PRIu64"us; compile mean:%"PRIu64"us; "
+            "%u deferred with queue full", cq->compiled,
+            cq->total_wait / cq->compiled, cq->max_wait,
+            cq->total_cgen / cq->compiled, cq->deferred);
+
+   free(cq);
+   j->compileq = NULL;
+}
+
 void jit_free(jit_t *j)
 {
+   if (j->compileq != NULL)
+      jit_stop_compiler(j);
+
    if (j->aotlib != NULL)
       ffi_unload_dll(j->aotlib);
 
@@ -145,6 +196,10 @@ void jit_free(jit_t *j)
       jit_free_func(j->funcs.items[i]);
    ACLEAR(j->funcs);
 
+   for (int i = 0; i < j->retired.count; i++)
+      free(j->retired.items[i]);
+   ACLEAR(j->retired);
+
    if (j->layouts != NULL) {
       hash_iter_t it = HASH_BEGIN;
       const void *key;
@@ -230,13 +285,32 @@ jit_handle_t jit_lazy_compile(jit_t *j, ident_t name)
    if (alias != NULL && alias != name)
       hash_put(j->index, alias, f);
 
-   APUSH(j->funcs, f);
+   if (j->funcs.count == j->funcs.limit) {
+      // The background compiler thread may be reading the array
+      // without a lock so copy it rather than reallocating in place
+      // and keep the old array until the JIT is freed
+      const unsigned limit = MAX(j->funcs.limit * 2, 256);
+      jit_func_t **items = xmalloc_array(limit, sizeof(jit_func_t *));
+      if (j->funcs.count > 0)
+         memcpy(items, j->funcs.items, j->funcs.count * sizeof(jit_func_t *));
+
+      if (j->funcs.items != NULL)
+         APUSH(j->retired, j->funcs.items);
+
+      atomic_store(&(j->funcs.items), items);
+      j->funcs.limit = limit;
+   }
+
+   j->funcs.items[j->funcs.count] = f;
+   atomic_store(&(j->funcs.count), j->funcs.count + 1);
    return f->handle;
 }
 
 jit_func_t *jit_get_func(jit_t *j, jit_handle_t handle)
 {
-   return AGET(j->funcs, handle);
+   assert(handle < relaxed_load(&(j->funcs.count)));
+   jit_func_t **items = atomic_load(&(j->funcs.items));
+   return items[handle];
 }
 
 jit_handle_t jit_compile(jit_t *j, ident_t name)
@@ -748,6 +822,16 @@ bool jit_has_runtime(jit_t *j)
    return j->runtime;
 }
 
+void jit_enable_threading(jit_t *j, bool enable)
+{
+   j->threaded = enable;
+}
+
+bool jit_has_threading(jit_t *j)
+{
+   return j->threaded;
+}
+
 int jit_backedge_limit(jit_t *j)
 {
    return j->backedge;
@@ -880,15 +964,85 @@ int jit_exit_status(jit_t *j)
    return j->exit_status;
 }
 
+static void *jit_compile_thread(void *arg)
+{
+   jit_t *j = arg;
+   compile_queue_t *cq = j->compileq;
+
+   for (;;) {
+      // Sleep until a request is queued or the JIT is being freed
+      nvc_sema_wait(&cq->pending);
+
+      if (atomic_load(&cq->stop))
+         break;
+
+      compile_req_t req;
+      {
+         SCOPED_LOCK(cq->lock);
+         assert(cq->rptr != cq->wptr);
+         req = cq->reqs[cq->rptr++ % COMPILE_QUEUE_SIZE];
+      }
+
+      const uint64_t start = get_timestamp_us();
+
+      // The code generator publishes the new entry point with an atomic
+      // store so no lock is held here and the main thread may continue
+      // to add functions
+      (*req.tier->plugin.cgen)(j, req.func->handle, req.tier->context);
+
+      const uint64_t end = get_timestamp_us();
+      const uint64_t wait = start - req.enqueued;
+
+      SCOPED_LOCK(cq->lock);
+      cq->compiled++;
+      cq->total_wait += wait;
+      cq->total_cgen += end - start;
+      cq->max_wait = MAX(cq->max_wait, wait);
+   }
+
+   return NULL;
+}
+
 void jit_tier_up(jit_func_t *f)
 {
-   assert(f->hotness <= 0);
-   assert(f->next_tier != NULL);
+   // Compilation to the next tier happens on a background thread while
+   // the function continues to run in the interpreter: the code
+   // generator replaces the entry point once the new code is ready
+
+   jit_t *j = f->jit;
+
+   if (j->compileq == NULL) {
+      compile_queue_t *cq = xcalloc(sizeof(compile_queue_t));
+      if (!atomic_cas(&j->compileq, NULL, cq))
+         free(cq);
+      else
+         cq->thread = thread_create(jit_compile_thread, j,
+                                    "JIT compiler thread");
+   }
 
-   (*f->next_tier->plugin.cgen)(f->jit, f->handle, f->next_tier->context);
+   compile_queue_t *cq = j->compileq;
+   SCOPED_LOCK(cq->lock);
 
-   f->hotness   = 0;
+   jit_tier_t *tier = f->next_tier;
+   if (tier == NULL)
+      return;   // Another thread already queued this function
+   else if (cq->wptr - cq->rptr == COMPILE_QUEUE_SIZE) {
+      // Queue is full: try again after another threshold of calls
+      relaxed_store(&f->hotness, tier->threshold);
+      cq->deferred++;
+      return;
+   }
+
+   cq->reqs[cq->wptr++ % COMPILE_QUEUE_SIZE] = (compile_req_t){
+      .func     = f,
+      .tier     = tier,
+      .enqueued = get_timestamp_us(),
+   };
+
+   relaxed_store(&f->hotness, 0);
    f->next_tier = NULL;
+
+   nvc_sema_post(&cq->pending);
 }
 
 void jit_add_tier(jit_t *j, int threshold, const jit_plugin_t *plugin)
@@ -612,6 +612,53 @@ void __nvc_div_zero(DEBUG_LOCUS(locus))
    x_div_zero(where);
 }
 
+DLLEXPORT
+void __nvc_do_exit(jit_exit_t which, jit_scalar_t *args)
+{
+   // Exits which abort the current call with arguments passed in the
+   // same way as the interpreter
+
+   switch (which) {
+   case JIT_EXIT_INDEX_FAIL:
+      x_index_fail(args[0].integer, args[1].integer, args[2].integer,
+                   args[3].integer, args[4].pointer, args[5].pointer);
+      break;
+
+   case JIT_EXIT_RANGE_FAIL:
+      x_range_fail(args[0].integer, args[1].integer, args[2].integer,
+                   args[3].integer, args[4].pointer, args[5].pointer);
+      break;
+
+   case JIT_EXIT_OVERFLOW:
+      x_overflow(args[0].integer, args[1].integer, args[2].pointer);
+      break;
+
+   case JIT_EXIT_NULL_DEREF:
+      x_null_deref(args[0].pointer);
+      break;
+
+   case JIT_EXIT_LENGTH_FAIL:
+      x_length_fail(args[0].integer, args[1].integer, args[2].integer,
+                    args[3].pointer);
+      break;
+
+   case JIT_EXIT_DIV_ZERO:
+      x_div_zero(args[0].pointer);
+      break;
+
+   case JIT_EXIT_EXPONENT_FAIL:
+      x_exponent_fail(args[0].integer, args[1].pointer);
+      break;
+
+   case JIT_EXIT_UNREACHABLE:
+      x_unreachable(args[0].pointer);
+      break;
+
+   default:
+      fatal_trace("unhandled exit %s", jit_exit_name(which));
+   }
+}
+
 DLLEXPORT
 int64_t _string_to_int(const uint8_t *raw_str, int32_t str_len, int32_t *used)
 {
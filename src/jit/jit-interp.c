@@ -23,6 +23,7 @@
 #include "jit/jit-priv.h"
 #include "jit/jit-ffi.h"
 #include "rt/mspace.h"
+#include "thread.h"
 #include "tree.h"
 #include "type.h"
 #include "vcode.h"
@@ -582,10 +583,29 @@ static void interp_cset(jit_interp_t *state, jit_ir_t *ir)
    state->regs[ir->result].integer = !!(state->flags);
 }
 
-static void interp_branch_to(jit_interp_t *state, jit_value_t label)
+static void interp_osr(jit_interp_t *state, jit_osr_fn_t fn)
+{
+   // Finish this call in compiled code starting from the loop header
+   // at the current PC
+
+   jit_osr_state_t osr = {
+      .regs   = state->regs,
+      .frame  = state->frame,
+      .target = state->pc,
+      .flags  = state->flags,
+   };
+
+   if (!(*fn)(state->func, state->args, &osr))
+      state->abort = true;
+}
+
+static bool interp_branch_to(jit_interp_t *state, jit_value_t label)
 {
    const int target = interp_get_value(state, label).integer;
-   if (state->backedge > 0 && target < state->pc) {
+   const bool backedge = target < state->pc;
+   const bool bounded = state->backedge > 0;
+
+   if (backedge && bounded) {
       // Limit the number of loop iterations in bounded mode
       if (--(state->backedge) == 0)
          interp_error(state, NULL, "maximum iteration limit reached");
@@ -593,22 +613,33 @@ static void interp_branch_to(jit_interp_t *state, jit_value_t label)
 
    state->pc = target;
    JIT_ASSERT(state->pc < state->func->nirs);
+
+   if (!backedge || bounded)
+      return false;
+
+   // Loop iterations count towards compiling the function in the
+   // same way as calls so a single long-running call can tier up
+   jit_func_t *f = state->func;
+   if (f->next_tier && relaxed_add(&f->hotness, -1) <= 0)
+      jit_tier_up(f);
+
+   jit_osr_fn_t osr = atomic_load(&f->osr_entry);
+   if (osr == NULL || target == 0)
+      return false;
+
+   interp_osr(state, osr);
+   return true;
 }
 
-static void interp_jump(jit_interp_t *state, jit_ir_t *ir)
+static bool interp_jump(jit_interp_t *state, jit_ir_t *ir)
 {
    switch (ir->cc) {
    case JIT_CC_NONE:
-      interp_branch_to(state, ir->arg1);
-      break;
+      return interp_branch_to(state, ir->arg1);
    case JIT_CC_T:
-      if (state->flags)
-         interp_branch_to(state, ir->arg1);
-      break;
+      return state->flags && interp_branch_to(state, ir->arg1);
    case JIT_CC_F:
-      if (!state->flags)
-         interp_branch_to(state, ir->arg1);
-      break;
+      return !state->flags && interp_branch_to(state, ir->arg1);
    default:
       interp_dump(state);
       fatal_trace("unhandled jump condition code");
@@ -1337,7 +1368,8 @@ static void interp_loop(jit_interp_t *state)
          interp_cset(state, ir);
          break;
       case J_JUMP:
-         interp_jump(state, ir);
+         if (interp_jump(state, ir))
+            return;   // Completed in compiled code
          break;
       case J_TRAP:
          interp_trap(state, ir);
@@ -1408,18 +1440,629 @@ static void interp_loop(jit_interp_t *state)
    } while (!state->abort);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Direct-threaded dispatch
+//
+// Each function is decoded once into an array of jit_insn_t parallel to
+// the IR where each slot holds the address of a handler specialised on
+// the opcode and operand kinds, and register numbers and immediates
+// extracted from the generic jit_value_t operands.  Common sequences are
+// fused into superinstructions which execute several consecutive IR
+// instructions with a single dispatch.  The later slots of a fused
+// sequence are still decoded normally so branches into the middle of a
+// sequence behave as before.
+
+typedef void (*interp_op_fn_t)(jit_interp_t *, jit_ir_t *);
+
+typedef struct _jit_insn {
+   const void *handler;
+   jit_ir_t   *ir;
+   union {
+      int64_t        imm;
+      interp_op_fn_t fn;
+   };
+   jit_reg_t   result;
+   jit_reg_t   arg1;
+   jit_reg_t   arg2;
+   jit_size_t  size;
+} jit_insn_t;
+
+#define ARITH_HANDLERS(x, OP)                                           \
+   x(OP##_RR) x(OP##_RI) x(OP##O_RR) x(OP##O_RI)                        \
+   x(OP##O_RR_JF) x(OP##O_RI_JF)
+
+#define CMP_HANDLERS(x, CC)                                             \
+   x(CMP_##CC##_RR) x(CMP_##CC##_RI)                                    \
+   x(CMP_##CC##_RR_JT) x(CMP_##CC##_RR_JF)                              \
+   x(CMP_##CC##_RI_JT) x(CMP_##CC##_RI_JF)
+
+#define MEMORY_HANDLERS(x, SZ)                                          \
+   x(LOADF_##SZ) x(LOADR_##SZ) x(STOREF_##SZ) x(STORER_##SZ)
+
+#define INTERP_HANDLERS(x)                                              \
+   x(GENERIC) x(NOP) x(RET) x(JUMP) x(JUMP_T) x(JUMP_F)                 \
+   x(RECV) x(SEND_R) x(SEND_I) x(MOV_R) x(MOV_I) x(CSET)                \
+   ARITH_HANDLERS(x, ADD) ARITH_HANDLERS(x, SUB) ARITH_HANDLERS(x, MUL) \
+   CMP_HANDLERS(x, EQ) CMP_HANDLERS(x, NE) CMP_HANDLERS(x, LT)          \
+   CMP_HANDLERS(x, GT) CMP_HANDLERS(x, LE) CMP_HANDLERS(x, GE)          \
+   MEMORY_HANDLERS(x, 8) MEMORY_HANDLERS(x, 16)                         \
+   MEMORY_HANDLERS(x, 32) MEMORY_HANDLERS(x, 64)                        \
+   x(LOADF_ADD_RI) x(LOADF_ADDO_RI) x(LOADF_ADDO_RI_JF)
+
+typedef enum {
+#define HANDLER_ENUM(name) H_##name,
+   INTERP_HANDLERS(HANDLER_ENUM)
+#undef HANDLER_ENUM
+} interp_handler_t;
+
+#define INTERP_CHECKED_OP(op)                                           \
+   static inline bool interp_##op##_overflow(jit_size_t size, int64_t a, \
+                                             int64_t b, int64_t *result) \
+   {                                                                    \
+      bool overflow = false;                                            \
+      switch (size) {                                                   \
+      case JIT_SZ_8:                                                    \
+         { int8_t r; overflow = __builtin_##op##_overflow(              \
+               (int8_t)a, (int8_t)b, &r); *result = r; }                \
+         break;                                                         \
+      case JIT_SZ_16:                                                   \
+         { int16_t r; overflow = __builtin_##op##_overflow(             \
+               (int16_t)a, (int16_t)b, &r); *result = r; }              \
+         break;                                                         \
+      case JIT_SZ_32:                                                   \
+         { int32_t r; overflow = __builtin_##op##_overflow(             \
+               (int32_t)a, (int32_t)b, &r); *result = r; }              \
+         break;                                                         \
+      default:                                                          \
+         overflow = __builtin_##op##_overflow(a, b, result);            \
+         break;                                                         \
+      }                                                                 \
+      return overflow;                                                  \
+   }
+
+INTERP_CHECKED_OP(add)
+INTERP_CHECKED_OP(sub)
+INTERP_CHECKED_OP(mul)
+
+static inline int64_t interp_load_sized(jit_size_t size, const void *ptr)
+{
+   switch (size) {
+   case JIT_SZ_8: return *(int8_t *)ptr;
+   case JIT_SZ_16: return *(int16_t *)ptr;
+   case JIT_SZ_32: return *(int32_t *)ptr;
+   default: return *(int64_t *)ptr;
+   }
+}
+
+static void interp_bad_op(jit_interp_t *state, jit_ir_t *ir)
+{
+   interp_dump(state);
+   fatal_trace("cannot interpret opcode %s", jit_op_name(ir->op));
+}
+
+static interp_op_fn_t interp_generic_fn(jit_op_t op)
+{
+   switch (op) {
+   case J_RECV: return interp_recv;
+   case J_SEND: return interp_send;
+   case J_AND: return interp_and;
+   case J_OR: return interp_or;
+   case J_XOR: return interp_xor;
+   case J_SUB: return interp_sub;
+   case J_FSUB: return interp_fsub;
+   case J_ADD: return interp_add;
+   case J_FADD: return interp_fadd;
+   case J_MUL: return interp_mul;
+   case J_FMUL: return interp_fmul;
+   case J_DIV: return interp_div;
+   case J_FDIV: return interp_fdiv;
+   case J_STORE: return interp_store;
+   case J_ULOAD: return interp_uload;
+   case J_LOAD: return interp_load;
+   case J_CMP: return interp_cmp;
+   case J_FCMP: return interp_fcmp;
+   case J_CSET: return interp_cset;
+   case J_TRAP: return interp_trap;
+   case J_CALL: return interp_call;
+   case J_MOV: return interp_mov;
+   case J_CSEL: return interp_csel;
+   case J_NEG: return interp_neg;
+   case J_FNEG: return interp_fneg;
+   case J_NOT: return interp_not;
+   case J_SCVTF: return interp_scvtf;
+   case J_FCVTNS: return interp_fcvtns;
+   case J_LEA: return interp_lea;
+   case J_REM: return interp_rem;
+   case MACRO_COPY: return interp_copy;
+   case MACRO_BZERO: return interp_bzero;
+   case MACRO_GALLOC: return interp_galloc;
+   case MACRO_EXIT: return interp_exit;
+   case MACRO_FEXP: return interp_fexp;
+   case MACRO_EXP: return interp_exp;
+   case MACRO_FFICALL: return interp_fficall;
+   case MACRO_GETPRIV: return interp_getpriv;
+   case MACRO_PUTPRIV: return interp_putpriv;
+   default: return interp_bad_op;
+   }
+}
+
+static inline bool interp_is_jump(jit_ir_t *ir, jit_cc_t cc)
+{
+   return ir != NULL && ir->op == J_JUMP && ir->cc == cc;
+}
+
+static interp_handler_t interp_decode_arith(jit_ir_t *ir, jit_ir_t *next,
+                                            jit_insn_t *insn,
+                                            interp_handler_t base)
+{
+   // Handlers for each arithmetic operation are in the order given by
+   // ARITH_HANDLERS
+   if (ir->arg1.kind != JIT_VALUE_REG)
+      return H_GENERIC;
+
+   insn->arg1 = ir->arg1.reg;
+
+   int offset;
+   if (ir->arg2.kind == JIT_VALUE_REG) {
+      insn->arg2 = ir->arg2.reg;
+      offset = 0;
+   }
+   else if (ir->arg2.kind == JIT_VALUE_INT64) {
+      insn->imm = ir->arg2.int64;
+      offset = 1;
+   }
+   else
+      return H_GENERIC;
+
+   switch (ir->cc) {
+   case JIT_CC_NONE:
+      return base + offset;
+   case JIT_CC_O:
+      if (interp_is_jump(next, JIT_CC_F))
+         return base + 4 + offset;   // Overflow check and branch
+      else
+         return base + 2 + offset;
+   default:
+      return H_GENERIC;
+   }
+}
+
+static interp_handler_t interp_decode_cmp(jit_ir_t *ir, jit_ir_t *next,
+                                          jit_insn_t *insn)
+{
+   interp_handler_t base;
+   switch (ir->cc) {
+   case JIT_CC_EQ: base = H_CMP_EQ_RR; break;
+   case JIT_CC_NE: base = H_CMP_NE_RR; break;
+   case JIT_CC_LT: base = H_CMP_LT_RR; break;
+   case JIT_CC_GT: base = H_CMP_GT_RR; break;
+   case JIT_CC_LE: base = H_CMP_LE_RR; break;
+   case JIT_CC_GE: base = H_CMP_GE_RR; break;
+   default: return H_GENERIC;
+   }
+
+   if (ir->arg1.kind != JIT_VALUE_REG)
+      return H_GENERIC;
+
+   insn->arg1 = ir->arg1.reg;
+
+   // Handlers for each condition code are in the order given by
+   // CMP_HANDLERS
+   int offset;
+   if (ir->arg2.kind == JIT_VALUE_REG) {
+      insn->arg2 = ir->arg2.reg;
+      offset = 0;
+   }
+   else if (ir->arg2.kind == JIT_VALUE_INT64) {
+      insn->imm = ir->arg2.int64;
+      offset = 1;
+   }
+   else
+      return H_GENERIC;
+
+   if (interp_is_jump(next, JIT_CC_T))
+      return base + 2 + 2 * offset;
+   else if (interp_is_jump(next, JIT_CC_F))
+      return base + 3 + 2 * offset;
+   else
+      return base + offset;
+}
+
+static interp_handler_t interp_decode_memory(jit_ir_t *ir, jit_insn_t *insn,
+                                             jit_value_t addr,
+                                             interp_handler_t frame,
+                                             interp_handler_t reg)
+{
+   // Handlers for each size are in the order given by MEMORY_HANDLERS
+   int offset;
+   switch (ir->size) {
+   case JIT_SZ_8: offset = 0; break;
+   case JIT_SZ_16: offset = 4; break;
+   case JIT_SZ_32: offset = 8; break;
+   case JIT_SZ_64: offset = 12; break;
+   default: return H_GENERIC;
+   }
+
+   switch (addr.kind) {
+   case JIT_ADDR_FRAME:
+      insn->imm = addr.int64;
+      return frame + offset;
+   case JIT_ADDR_REG:
+      insn->arg2 = addr.reg;
+      insn->imm = addr.disp;
+      return reg + offset;
+   default:
+      return H_GENERIC;
+   }
+}
+
+static interp_handler_t interp_decode_load(jit_ir_t *ir, jit_ir_t *next,
+                                           jit_ir_t *next2, jit_insn_t *insn)
+{
+   const interp_handler_t h =
+      interp_decode_memory(ir, insn, ir->arg1, H_LOADF_8, H_LOADR_8);
+
+   if (h == H_GENERIC || ir->arg1.kind != JIT_ADDR_FRAME)
+      return h;
+
+   // Fuse a load from the frame with an immediately following add of
+   // a constant to the loaded value
+   const bool fuse_add = next != NULL
+      && next->op == J_ADD
+      && next->arg1.kind == JIT_VALUE_REG
+      && next->arg1.reg == ir->result
+      && next->arg2.kind == JIT_VALUE_INT64;
+
+   if (!fuse_add)
+      return h;
+   else if (next->cc == JIT_CC_NONE)
+      return H_LOADF_ADD_RI;
+   else if (next->cc != JIT_CC_O)
+      return h;
+   else if (interp_is_jump(next2, JIT_CC_F))
+      return H_LOADF_ADDO_RI_JF;
+   else
+      return H_LOADF_ADDO_RI;
+}
+
+static interp_handler_t interp_decode(jit_ir_t *ir, jit_ir_t *next,
+                                      jit_ir_t *next2, jit_insn_t *insn)
+{
+   switch (ir->op) {
+   case J_DEBUG:
+      return H_NOP;
+   case J_RET:
+      return H_RET;
+   case J_JUMP:
+      assert(ir->arg1.kind == JIT_VALUE_LABEL);
+      insn->imm = ir->arg1.label;
+      switch (ir->cc) {
+      case JIT_CC_NONE: return H_JUMP;
+      case JIT_CC_T: return H_JUMP_T;
+      case JIT_CC_F: return H_JUMP_F;
+      default: fatal_trace("unhandled jump condition code");
+      }
+   case J_RECV:
+      assert(ir->arg1.kind == JIT_VALUE_INT64);
+      assert(ir->arg1.int64 < JIT_MAX_ARGS);
+      insn->arg1 = ir->arg1.int64;
+      return H_RECV;
+   case J_SEND:
+      assert(ir->arg1.kind == JIT_VALUE_INT64);
+      assert(ir->arg1.int64 < JIT_MAX_ARGS);
+      insn->arg1 = ir->arg1.int64;
+      if (ir->arg2.kind == JIT_VALUE_REG) {
+         insn->arg2 = ir->arg2.reg;
+         return H_SEND_R;
+      }
+      else if (ir->arg2.kind == JIT_VALUE_INT64) {
+         insn->imm = ir->arg2.int64;
+         return H_SEND_I;
+      }
+      else
+         return H_GENERIC;
+   case J_MOV:
+      if (ir->arg1.kind == JIT_VALUE_REG) {
+         insn->arg1 = ir->arg1.reg;
+         return H_MOV_R;
+      }
+      else if (ir->arg1.kind == JIT_VALUE_INT64) {
+         insn->imm = ir->arg1.int64;
+         return H_MOV_I;
+      }
+      else
+         return H_GENERIC;
+   case J_CSET:
+      return H_CSET;
+   case J_ADD:
+      return interp_decode_arith(ir, next, insn, H_ADD_RR);
+   case J_SUB:
+      return interp_decode_arith(ir, next, insn, H_SUB_RR);
+   case J_MUL:
+      return interp_decode_arith(ir, next, insn, H_MUL_RR);
+   case J_CMP:
+      return interp_decode_cmp(ir, next, insn);
+   case J_LOAD:
+      return interp_decode_load(ir, next, next2, insn);
+   case J_STORE:
+      if (ir->arg1.kind != JIT_VALUE_REG)
+         return H_GENERIC;
+      insn->arg1 = ir->arg1.reg;
+      return interp_decode_memory(ir, insn, ir->arg2, H_STOREF_8, H_STORER_8);
+   default:
+      return H_GENERIC;
+   }
+}
+
+static jit_insn_t *interp_predecode(jit_func_t *f, const void *const *handlers)
+{
+   jit_insn_t *code = xcalloc_array(f->nirs, sizeof(jit_insn_t));
+
+   for (int i = 0; i < f->nirs; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+      jit_ir_t *next = i + 1 < f->nirs ? ir + 1 : NULL;
+      jit_ir_t *next2 = i + 2 < f->nirs ? ir + 2 : NULL;
+
+      jit_insn_t *insn = &(code[i]);
+      insn->ir     = ir;
+      insn->result = ir->result;
+      insn->size   = ir->size;
+
+      const interp_handler_t h = interp_decode(ir, next, next2, insn);
+      if (h == H_GENERIC)
+         insn->fn = interp_generic_fn(ir->op);
+
+      insn->handler = handlers[h];
+   }
+
+   return code;
+}
+
+static void interp_threaded(jit_interp_t *state)
+{
+   static const void *const handlers[] = {
+#define HANDLER_ADDR(name) [H_##name] = &&L_##name,
+      INTERP_HANDLERS(HANDLER_ADDR)
+#undef HANDLER_ADDR
+   };
+
+   jit_func_t *f = state->func;
+   jit_insn_t *code = atomic_load(&f->threaded);
+   if (code == NULL) {
+      code = interp_predecode(f, handlers);
+      if (!atomic_cas(&f->threaded, NULL, code)) {
+         free(code);
+         code = atomic_load(&f->threaded);
+      }
+   }
+
+   jit_scalar_t *regs = state->regs;
+   unsigned char *frame = state->frame;
+   jit_insn_t *insn = code + state->pc;
+
+#define DISPATCH() goto *(insn->handler)
+#define NEXT(n) do { insn += (n); DISPATCH(); } while (0)
+
+   // Forward branches are resolved directly but backward branches go
+   // through the same path as the switch interpreter for the iteration
+   // limit, hotness counting, and on-stack replacement
+#define BRANCH(jump) do {                                               \
+      if ((jump)->imm > (jump) - code) {                                \
+         insn = code + (jump)->imm;                                     \
+         DISPATCH();                                                    \
+      }                                                                 \
+      state->pc = (jump) - code + 1;                                    \
+      if (interp_branch_to(state, (jump)->ir->arg1) || state->abort)    \
+         return;                                                        \
+      insn = code + state->pc;                                          \
+      DISPATCH();                                                       \
+   } while (0)
+
+   DISPATCH();
+
+ L_GENERIC:
+   state->pc = insn - code + 1;
+   (*insn->fn)(state, insn->ir);
+   if (state->abort)
+      return;
+   NEXT(1);
+
+ L_NOP:
+   NEXT(1);
+
+ L_RET:
+   state->pc = insn - code + 1;
+   return;
+
+ L_JUMP:
+   BRANCH(insn);
+
+ L_JUMP_T:
+   if (state->flags)
+      BRANCH(insn);
+   NEXT(1);
+
+ L_JUMP_F:
+   if (!state->flags)
+      BRANCH(insn);
+   NEXT(1);
+
+ L_RECV:
+   regs[insn->result] = state->args[insn->arg1];
+   state->nargs = MAX(state->nargs, insn->arg1 + 1);
+   NEXT(1);
+
+ L_SEND_R:
+   state->args[insn->arg1] = regs[insn->arg2];
+   state->nargs = MAX(state->nargs, insn->arg1 + 1);
+   NEXT(1);
+
+ L_SEND_I:
+   state->args[insn->arg1].integer = insn->imm;
+   state->nargs = MAX(state->nargs, insn->arg1 + 1);
+   NEXT(1);
+
+ L_MOV_R:
+   regs[insn->result] = regs[insn->arg1];
+   NEXT(1);
+
+ L_MOV_I:
+   regs[insn->result].integer = insn->imm;
+   NEXT(1);
+
+ L_CSET:
+   regs[insn->result].integer = !!(state->flags);
+   NEXT(1);
+
+#define ARITH_IMPL(OP, op, sym)                                         \
+   L_##OP##_RR:                                                         \
+      regs[insn->result].integer =                                      \
+         regs[insn->arg1].integer sym regs[insn->arg2].integer;         \
+      NEXT(1);                                                          \
+   L_##OP##_RI:                                                         \
+      regs[insn->result].integer = regs[insn->arg1].integer sym insn->imm; \
+      NEXT(1);                                                          \
+   L_##OP##O_RR:                                                        \
+      state->flags = interp_##op##_overflow(                            \
+         insn->size, regs[insn->arg1].integer, regs[insn->arg2].integer, \
+         &(regs[insn->result].integer)) << JIT_CC_O;                    \
+      NEXT(1);                                                          \
+   L_##OP##O_RI:                                                        \
+      state->flags = interp_##op##_overflow(                            \
+         insn->size, regs[insn->arg1].integer, insn->imm,               \
+         &(regs[insn->result].integer)) << JIT_CC_O;                    \
+      NEXT(1);                                                          \
+   L_##OP##O_RR_JF:                                                     \
+      state->flags = interp_##op##_overflow(                            \
+         insn->size, regs[insn->arg1].integer, regs[insn->arg2].integer, \
+         &(regs[insn->result].integer)) << JIT_CC_O;                    \
+      if (!state->flags)                                                \
+         BRANCH(insn + 1);                                              \
+      NEXT(2);                                                          \
+   L_##OP##O_RI_JF:                                                     \
+      state->flags = interp_##op##_overflow(                            \
+         insn->size, regs[insn->arg1].integer, insn->imm,               \
+         &(regs[insn->result].integer)) << JIT_CC_O;                    \
+      if (!state->flags)                                                \
+         BRANCH(insn + 1);                                              \
+      NEXT(2);
+
+   ARITH_IMPL(ADD, add, +);
+   ARITH_IMPL(SUB, sub, -);
+   ARITH_IMPL(MUL, mul, *);
+
+#undef ARITH_IMPL
+
+#define CMP_IMPL(CC, sym)                                               \
+   L_CMP_##CC##_RR:                                                     \
+      state->flags = (regs[insn->arg1].integer sym                      \
+                      regs[insn->arg2].integer) << JIT_CC_##CC;         \
+      NEXT(1);                                                          \
+   L_CMP_##CC##_RI:                                                     \
+      state->flags = (regs[insn->arg1].integer sym insn->imm)           \
+         << JIT_CC_##CC;                                                \
+      NEXT(1);                                                          \
+   L_CMP_##CC##_RR_JT:                                                  \
+      state->flags = (regs[insn->arg1].integer sym                      \
+                      regs[insn->arg2].integer) << JIT_CC_##CC;         \
+      if (state->flags)                                                 \
+         BRANCH(insn + 1);                                              \
+      NEXT(2);                                                          \
+   L_CMP_##CC##_RR_JF:                                                  \
+      state->flags = (regs[insn->arg1].integer sym                      \
+                      regs[insn->arg2].integer) << JIT_CC_##CC;         \
+      if (!state->flags)                                                \
+         BRANCH(insn + 1);                                              \
+      NEXT(2);                                                          \
+   L_CMP_##CC##_RI_JT:                                                  \
+      state->flags = (regs[insn->arg1].integer sym insn->imm)           \
+         << JIT_CC_##CC;                                                \
+      if (state->flags)                                                 \
+         BRANCH(insn + 1);                                              \
+      NEXT(2);                                                          \
+   L_CMP_##CC##_RI_JF:                                                  \
+      state->flags = (regs[insn->arg1].integer sym insn->imm)           \
+         << JIT_CC_##CC;                                                \
+      if (!state->flags)                                                \
+         BRANCH(insn + 1);                                              \
+      NEXT(2);
+
+   CMP_IMPL(EQ, ==);
+   CMP_IMPL(NE, !=);
+   CMP_IMPL(LT, <);
+   CMP_IMPL(GT, >);
+   CMP_IMPL(LE, <=);
+   CMP_IMPL(GE, >=);
+
+#undef CMP_IMPL
+
+#define MEMORY_IMPL(SZ, type)                                           \
+   L_LOADF_##SZ:                                                        \
+      regs[insn->result].integer = *(type *)(frame + insn->imm);        \
+      NEXT(1);                                                          \
+   L_LOADR_##SZ:                                                        \
+      regs[insn->result].integer =                                      \
+         *(type *)(regs[insn->arg2].pointer + insn->imm);               \
+      NEXT(1);                                                          \
+   L_STOREF_##SZ:                                                       \
+      *(type *)(frame + insn->imm) = regs[insn->arg1].integer;          \
+      NEXT(1);                                                          \
+   L_STORER_##SZ:                                                       \
+      *(type *)(regs[insn->arg2].pointer + insn->imm) =                 \
+         regs[insn->arg1].integer;                                      \
+      NEXT(1);
+
+   MEMORY_IMPL(8, int8_t);
+   MEMORY_IMPL(16, int16_t);
+   MEMORY_IMPL(32, int32_t);
+   MEMORY_IMPL(64, int64_t);
+
+#undef MEMORY_IMPL
+
+ L_LOADF_ADD_RI:
+   regs[insn[0].result].integer =
+      interp_load_sized(insn[0].size, frame + insn[0].imm);
+   regs[insn[1].result].integer =
+      regs[insn[0].result].integer + insn[1].imm;
+   NEXT(2);
+
+ L_LOADF_ADDO_RI:
+   regs[insn[0].result].integer =
+      interp_load_sized(insn[0].size, frame + insn[0].imm);
+   state->flags = interp_add_overflow(
+      insn[1].size, regs[insn[0].result].integer, insn[1].imm,
+      &(regs[insn[1].result].integer)) << JIT_CC_O;
+   NEXT(2);
+
+ L_LOADF_ADDO_RI_JF:
+   regs[insn[0].result].integer =
+      interp_load_sized(insn[0].size, frame + insn[0].imm);
+   state->flags = interp_add_overflow(
+      insn[1].size, regs[insn[0].result].integer, insn[1].imm,
+      &(regs[insn[1].result].integer)) << JIT_CC_O;
+   if (!state->flags)
+      BRANCH(insn + 2);
+   NEXT(3);
+
+#undef BRANCH
+#undef NEXT
+#undef DISPATCH
+}
+
 bool jit_interp(jit_func_t *f, jit_scalar_t *args)
 {
-   if (f->entry != jit_interp) {
+   // The entry point may be replaced by the background compiler
+   jit_entry_fn_t entry = atomic_load(&f->entry);
+   if (entry != jit_interp) {
       // Came from stale compiled code
       // TODO: should we patch the call site?
-      return (*f->entry)(f, args);
+      return (*entry)(f, args);
    }
 
    if (f->irbuf == NULL)
       jit_irgen(f);
 
-   if (f->next_tier && --(f->hotness) <= 0)
+   if (f->next_tier && relaxed_add(&f->hotness, -1) <= 0)
       jit_tier_up(f);
 
    // Using VLAs here as we need these allocated on the stack so the
@@ -1446,7 +2089,10 @@ bool jit_interp(jit_func_t *f, jit_scalar_t *args)
 
    call_stack = &state;
 
-   interp_loop(&state);
+   if (jit_has_threading(f->jit))
+      interp_threaded(&state);
+   else
+      interp_loop(&state);
 
    assert(call_stack == &state);
    call_stack = state.caller;
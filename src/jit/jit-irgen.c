@@ -23,6 +23,7 @@
 #include "lib.h"
 #include "mask.h"
 #include "opt.h"
+#include "rt/mspace.h"
 #include "tree.h"
 #include "vcode.h"
 
@@ -3408,10 +3409,8 @@ static bool irgen_is_procedure(void)
    }
 }
 
-void jit_irgen(jit_func_t *f)
+static void irgen_function(jit_func_t *f)
 {
-   assert(f->irbuf == NULL);
-
    vcode_select_unit(f->unit);
 
    const bool debug_log = opt_get_int(OPT_JIT_LOG) && f->name != NULL;
@@ -3496,6 +3495,8 @@ void jit_irgen(jit_func_t *f)
 #endif
    }
 
+   jit_optimise(f);
+
    if (debug_log) {
       const int ticks = get_timestamp_us() - start_ticks;
       diag_t *d = diag_new(DIAG_DEBUG, NULL);
@@ -3511,3 +3512,16 @@ void jit_irgen(jit_func_t *f)
    free(g->vars);
    free(g);
 }
+
+void jit_irgen(jit_func_t *f)
+{
+   // Other threads may be executing code from the same JIT so make sure
+   // they cannot observe a partially generated function
+   mspace_t *m = jit_get_mspace(f->jit);
+   mspace_stop_world(m);
+
+   if (f->irbuf == NULL)
+      irgen_function(f);
+
+   mspace_start_world(m);
+}
@@ -16,6 +16,8 @@
 //
 
 #include "util.h"
+#include "array.h"
+#include "diag.h"
 #include "ident.h"
 #include "jit/jit-priv.h"
 #include "opt.h"
@@ -24,7 +26,12 @@
 #ifdef LLVM_HAS_LLJIT
 
 #include <assert.h>
+#include <libgen.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <llvm-c/Analysis.h>
 #include <llvm-c/BitReader.h>
@@ -33,6 +40,8 @@
 #include <llvm-c/Error.h>
 #include <llvm-c/ExecutionEngine.h>
 #include <llvm-c/LLJIT.h>
+#include <llvm-c/Object.h>
+#include <llvm-c/OrcEE.h>
 #include <llvm-c/Transforms/Scalar.h>
 
 typedef enum {
@@ -51,6 +60,8 @@ typedef enum {
    LLVM_PAIR_I64_I1,
 
    LLVM_ENTRY_FN,
+   LLVM_OSR_FN,
+   LLVM_EXIT_FN,
 
    LLVM_LAST_TYPE
 } llvm_type_t;
@@ -105,6 +116,7 @@ typedef struct {
    LLVMTargetMachineRef target;
    LLVMValueRef         llvmfn;
    LLVMValueRef         args;
+   LLVMValueRef         osrstate;
    LLVMValueRef         frame;
    LLVMTypeRef          types[LLVM_LAST_TYPE];
    LLVMValueRef         fns[LLVM_LAST_FN];
@@ -115,6 +127,9 @@ typedef struct {
    jit_cfg_t           *cfg;
    char                *name;
    text_buf_t          *textbuf;
+   LLVMDIBuilderRef     debuginfo;
+   LLVMMetadataRef      debugscope;
+   bool                 osr;
 } cgen_req_t;
 
 typedef struct {
@@ -122,8 +137,20 @@ typedef struct {
    LLVMOrcLLJITRef             jit;
    LLVMOrcExecutionSessionRef  session;
    LLVMOrcJITDylibRef          dylib;
+   FILE                       *perfmap;
+   nvc_lock_t                  perflock;
+   char                        prefix;
 } lljit_state_t;
 
+typedef struct {
+   char     *name;
+   uint64_t  size;
+} symbol_size_t;
+
+// Sizes of the symbols in the last object emitted on this thread which
+// are not available from the LLJIT lookup interface
+static __thread A(symbol_size_t) last_symbols;
+
 #define LLVM_CHECK(op, ...) do {                        \
       LLVMErrorRef error = op(__VA_ARGS__);             \
       if (unlikely(error != LLVMErrorSuccess)) {        \
@@ -654,6 +681,12 @@ static void cgen_op_cmp(cgen_req_t *req, cgen_block_t *cgb, jit_ir_t *ir)
    case JIT_CC_LT:
       cgb->outflags = LLVMBuildICmp(req->builder, LLVMIntSLT, arg1, arg2, "");
       break;
+   case JIT_CC_GE:
+      cgb->outflags = LLVMBuildICmp(req->builder, LLVMIntSGE, arg1, arg2, "");
+      break;
+   case JIT_CC_LE:
+      cgb->outflags = LLVMBuildICmp(req->builder, LLVMIntSLE, arg1, arg2, "");
+      break;
    default:
       jit_dump_with_mark(req->func, ir - req->func->irbuf, false);
       fatal_trace("unhandled cmp condition code");
@@ -699,6 +732,35 @@ static void cgen_op_call(cgen_req_t *req, cgen_block_t *cgb, jit_ir_t *ir)
                   args, ARRAY_LEN(args), "");
 }
 
+static void cgen_op_exit(cgen_req_t *req, jit_ir_t *ir)
+{
+   switch (ir->arg1.exit) {
+   case JIT_EXIT_INDEX_FAIL:
+   case JIT_EXIT_RANGE_FAIL:
+   case JIT_EXIT_OVERFLOW:
+   case JIT_EXIT_NULL_DEREF:
+   case JIT_EXIT_LENGTH_FAIL:
+   case JIT_EXIT_DIV_ZERO:
+   case JIT_EXIT_EXPONENT_FAIL:
+   case JIT_EXIT_UNREACHABLE:
+      break;
+   default:
+      warnf("cannot generate LLVM for exit %s", jit_exit_name(ir->arg1.exit));
+      return;
+   }
+
+   LLVMValueRef args[] = {
+      llvm_int32(req, ir->arg1.exit),
+      req->args
+   };
+   LLVMBuildCall2(req->builder, req->types[LLVM_EXIT_FN],
+                  llvm_ptr(req, __nvc_do_exit), args, ARRAY_LEN(args), "");
+
+   // The error has been reported and the interpreter unwinds the
+   // call when it sees the failure
+   LLVMBuildRet(req->builder, llvm_int1(req, false));
+}
+
 static void cgen_op_lea(cgen_req_t *req, cgen_block_t *cgb, jit_ir_t *ir)
 {
    LLVMValueRef ptr = cgen_get_value(req, cgb, ir->arg1);
@@ -730,6 +792,80 @@ static void cgen_op_copy(cgen_req_t *req, cgen_block_t *cgb, jit_ir_t *ir)
    LLVMBuildMemMove(req->builder, dest, 0, src, 0, count);
 }
 
+static void cgen_debug_loc(cgen_req_t *req, const loc_t *loc)
+{
+   if (req->debuginfo == NULL || loc_invalid_p(loc))
+      return;
+
+   LLVMMetadataRef dloc = LLVMDIBuilderCreateDebugLocation(
+      req->context, loc->first_line, loc->first_column,
+      req->debugscope, NULL);
+#ifdef LLVM_HAVE_SET_CURRENT_DEBUG_LOCATION_2
+   LLVMSetCurrentDebugLocation2(req->builder, dloc);
+#else
+   LLVMValueRef md = LLVMMetadataAsValue(req->context, dloc);
+   LLVMSetCurrentDebugLocation(req->builder, md);
+#endif
+}
+
+static void cgen_debug_info(cgen_req_t *req)
+{
+   // Line tables allow perf to annotate samples in generated code with
+   // the VHDL source: use the first debug locus for the function itself
+   const loc_t *loc = NULL;
+   for (int i = 0; i < req->func->nirs && loc == NULL; i++) {
+      if (req->func->irbuf[i].op == J_DEBUG)
+         loc = &(req->func->irbuf[i].arg1.loc);
+   }
+
+   const char *file_path;
+   if (loc == NULL || (file_path = loc_file_str(loc)) == NULL)
+      return;
+
+   req->debuginfo = LLVMCreateDIBuilder(req->module);
+
+   char *basec LOCAL = xstrdup(file_path);
+   char *dirc LOCAL = xstrdup(file_path);
+
+   const char *file = basename(basec);
+   const char *dir = dirname(dirc);
+
+   LLVMMetadataRef file_ref = LLVMDIBuilderCreateFile(
+      req->debuginfo, file, strlen(file), dir, strlen(dir));
+
+   LLVMMetadataRef cu = LLVMDIBuilderCreateCompileUnit(
+      req->debuginfo, LLVMDWARFSourceLanguageAda83,
+      file_ref, PACKAGE, sizeof(PACKAGE) - 1,
+      true, "", 0, 0, "", 0,
+      LLVMDWARFEmissionLineTablesOnly, 0, false, false
+#if LLVM_CREATE_CU_HAS_SYSROOT
+      , "/", 1, "", 0
+#endif
+   );
+
+   const size_t namelen = strlen(req->name);
+   LLVMMetadataRef dtype = LLVMDIBuilderCreateSubroutineType(
+      req->debuginfo, file_ref, NULL, 0, 0);
+   req->debugscope = LLVMDIBuilderCreateFunction(
+      req->debuginfo, cu, req->name, namelen, req->name, namelen,
+      file_ref, loc->first_line, dtype, true, true,
+      loc->first_line, 0, true);
+   LLVMSetSubprogram(req->llvmfn, req->debugscope);
+
+   const char dwarf_version[] = "Dwarf Version";
+   LLVMAddModuleFlag(req->module, LLVMModuleFlagBehaviorWarning,
+                     dwarf_version, sizeof(dwarf_version) - 1,
+                     LLVMValueAsMetadata(llvm_int32(req, 4)));
+
+   const char debug_version[] = "Debug Info Version";
+   LLVMAddModuleFlag(req->module, LLVMModuleFlagBehaviorWarning,
+                     debug_version, sizeof(debug_version) - 1,
+                     LLVMValueAsMetadata(
+                        llvm_int32(req, LLVMDebugMetadataVersion())));
+
+   cgen_debug_loc(req, loc);
+}
+
 static void cgen_ir(cgen_req_t *req, cgen_block_t *cgb, jit_ir_t *ir)
 {
    switch (ir->op) {
@@ -770,6 +906,7 @@ static void cgen_ir(cgen_req_t *req, cgen_block_t *cgb, jit_ir_t *ir)
       cgen_op_csel(req, cgb, ir);
       break;
    case J_DEBUG:
+      cgen_debug_loc(req, &(ir->arg1.loc));
       break;
    case J_CALL:
       cgen_op_call(req, cgb, ir);
@@ -786,6 +923,9 @@ static void cgen_ir(cgen_req_t *req, cgen_block_t *cgb, jit_ir_t *ir)
    case MACRO_COPY:
       cgen_op_copy(req, cgb, ir);
       break;
+   case MACRO_EXIT:
+      cgen_op_exit(req, ir);
+      break;
    default:
       warnf("cannot generate LLVM for %s", jit_op_name(ir->op));
    }
@@ -899,6 +1039,13 @@ static void cgen_reg_types(cgen_req_t *req)
       case J_LOAD:
       case J_MUL:
       case J_ADD:
+         if (ir->arg1.kind == JIT_VALUE_REG
+             && req->regtypes[ir->arg1.reg] == LLVM_PTR) {
+            // Adding an offset to a pointer generates a GEP
+            cgen_force_reg_type(req, ir->result, LLVM_PTR);
+            break;
+         }
+         // Fall-through
       case J_SUB:
          cgen_force_reg_size(req, ir->result, ir->size, LLVM_INTPTR);
          cgen_hint_value_size(req, ir->arg1, ir->size, LLVM_INTPTR);
@@ -948,45 +1095,141 @@ static void cgen_reg_types(cgen_req_t *req)
          fatal_trace("cannot infer result type for %s", jit_op_name(ir->op));
       }
    }
+}
 
-   cgen_dump_reg_types(req);
+static bool cgen_has_loops(jit_func_t *f)
+{
+   for (int i = 0; i < f->nirs; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+      if (ir->op == J_JUMP && ir->arg1.kind == JIT_VALUE_LABEL
+          && ir->arg1.label > 0 && ir->arg1.label <= i)
+         return true;
+   }
+
+   return false;
 }
 
-static void cgen_module(cgen_req_t *req)
+static LLVMValueRef cgen_load_osr_field(cgen_req_t *req, llvm_type_t type,
+                                        size_t offset, const char *name)
 {
-   req->module  = LLVMModuleCreateWithNameInContext(req->name, req->context);
-   req->builder = LLVMCreateBuilderInContext(req->context);
+   LLVMValueRef indexes[] = { llvm_int64(req, offset) };
+   LLVMValueRef ptr = LLVMBuildInBoundsGEP2(req->builder,
+                                            req->types[LLVM_INT8],
+                                            req->osrstate, indexes,
+                                            ARRAY_LEN(indexes), "");
+   return LLVMBuildLoad2(req->builder, req->types[type], ptr, name);
+}
 
-   char *triple = LLVMGetTargetMachineTriple(req->target);
-   LLVMSetTarget(req->module, triple);
-   LLVMDisposeMessage(triple);
+static void cgen_osr_entry(cgen_req_t *req, LLVMBasicBlockRef entry_bb)
+{
+   // The interpreter calls this part way through a loop and execution
+   // resumes at the loop header with the interpreter's registers and
+   // flags: the frame is the interpreter's own rather than a copy as
+   // registers may hold addresses within it
 
-   LLVMTargetDataRef data_ref = LLVMCreateTargetDataLayout(req->target);
-   LLVMSetModuleDataLayout(req->module, data_ref);
+   LLVMBasicBlockRef bad_bb = cgen_append_block(req, "osr.bad");
 
-   req->types[LLVM_VOID]   = LLVMVoidTypeInContext(req->context);
-   req->types[LLVM_PTR]    = LLVMPointerTypeInContext(req->context, 0);
-   req->types[LLVM_INT1]   = LLVMInt1TypeInContext(req->context);
-   req->types[LLVM_INT8]   = LLVMInt8TypeInContext(req->context);
-   req->types[LLVM_INT16]  = LLVMInt16TypeInContext(req->context);
-   req->types[LLVM_INT32]  = LLVMInt32TypeInContext(req->context);
-   req->types[LLVM_INT64]  = LLVMInt64TypeInContext(req->context);
-   req->types[LLVM_INTPTR] = LLVMIntPtrTypeInContext(req->context, data_ref);
+   LLVMPositionBuilderAtEnd(req->builder, bad_bb);
+   LLVMBuildUnreachable(req->builder);
 
-   LLVMTypeRef atypes[] = { req->types[LLVM_PTR], req->types[LLVM_PTR] };
-   req->types[LLVM_ENTRY_FN] = LLVMFunctionType(req->types[LLVM_INT1], atypes,
-                                                ARRAY_LEN(atypes), false);
+   LLVMPositionBuilderAtEnd(req->builder, entry_bb);
 
-   req->llvmfn = LLVMAddFunction(req->module, req->name,
-                                 req->types[LLVM_ENTRY_FN]);
+   LLVMValueRef regs = cgen_load_osr_field(req, LLVM_PTR,
+                                           offsetof(jit_osr_state_t, regs),
+                                           "regs");
+   LLVMValueRef target = cgen_load_osr_field(req, LLVM_INT32,
+                                             offsetof(jit_osr_state_t, target),
+                                             "target");
+   LLVMValueRef flags32 = cgen_load_osr_field(req, LLVM_INT32,
+                                              offsetof(jit_osr_state_t, flags),
+                                              "");
+   LLVMValueRef flags = LLVMBuildICmp(req->builder, LLVMIntNE, flags32,
+                                      llvm_int32(req, 0), "flags");
+
+   LLVMValueRef sw = LLVMBuildSwitch(req->builder, target, bad_bb, 0);
+
+   jit_cfg_t *cfg = req->cfg;
+   for (int i = 1; i < cfg->nblocks; i++) {
+      jit_block_t *bb = &(cfg->blocks[i]);
+      cgen_block_t *cgb = &(req->blocks[i]);
+
+      bool header = false;
+      for (int j = 0; j < bb->in.count; j++)
+         header |= jit_get_edge(&bb->in, j) >= i;
+
+      if (!header)
+         continue;
+
+#ifdef DEBUG
+      char name[32];
+      checked_sprintf(name, sizeof(name), "osr.BB%d", i);
+#else
+      const char *name = "";
+#endif
+
+      LLVMBasicBlockRef case_bb = cgen_append_block(req, name);
+      LLVMAddCase(sw, llvm_int32(req, bb->first), case_bb);
+
+      LLVMPositionBuilderAtEnd(req->builder, case_bb);
+
+      for (int j = 0; j < req->func->nregs; j++) {
+         if (cgb->inregs[j] == NULL)
+            continue;
+
+         LLVMValueRef indexes[] = { llvm_int32(req, j) };
+         LLVMValueRef ptr = LLVMBuildInBoundsGEP2(req->builder,
+                                                  req->types[LLVM_INT64],
+                                                  regs, indexes,
+                                                  ARRAY_LEN(indexes), "");
+         // Interpreter registers are always 64 bits wide so load the
+         // whole slot and narrow it, which is independent of endianness
+         LLVMValueRef slot = LLVMBuildLoad2(req->builder,
+                                            req->types[LLVM_INT64], ptr, "");
+         LLVMTypeRef type = req->types[req->regtypes[j]];
+         LLVMValueRef value;
+         if (req->regtypes[j] == LLVM_PTR)
+            value = LLVMBuildIntToPtr(req->builder, slot, type,
+                                      cgen_reg_name(j));
+         else
+            value = LLVMBuildTruncOrBitCast(req->builder, slot, type,
+                                            cgen_reg_name(j));
+         LLVMAddIncoming(cgb->inregs[j], &value, &case_bb, 1);
+      }
+
+      LLVMAddIncoming(cgb->inflags, &flags, &case_bb, 1);
+      LLVMBuildBr(req->builder, cgb->bbref);
+   }
+}
+
+static void cgen_function(cgen_req_t *req, const char *name, bool osr)
+{
+   if (osr) {
+      req->llvmfn = LLVMAddFunction(req->module, name,
+                                    req->types[LLVM_OSR_FN]);
+
+      req->osrstate = LLVMGetParam(req->llvmfn, 2);
+      LLVMSetValueName(req->osrstate, "osr");
+   }
+   else {
+      req->llvmfn = LLVMAddFunction(req->module, name,
+                                    req->types[LLVM_ENTRY_FN]);
+      req->osrstate = NULL;
+   }
 
    LLVMBasicBlockRef entry_bb = cgen_append_block(req, "entry");
    LLVMPositionBuilderAtEnd(req->builder, entry_bb);
 
+   if (!osr && opt_get_int(OPT_PERF_MAP))
+      cgen_debug_info(req);
+
    req->args = LLVMGetParam(req->llvmfn, 1);
    LLVMSetValueName(req->args, "args");
 
-   if (req->func->framesz > 0) {
+   if (req->func->framesz > 0 && osr)
+      req->frame = cgen_load_osr_field(req, LLVM_PTR,
+                                       offsetof(jit_osr_state_t, frame),
+                                       "frame");
+   else if (req->func->framesz > 0) {
       LLVMTypeRef frame_type =
          LLVMArrayType(req->types[LLVM_INT8], req->func->framesz);
       req->frame = LLVMBuildAlloca(req->builder, frame_type, "frame");
@@ -998,7 +1241,10 @@ static void cgen_module(cgen_req_t *req)
 
    cgen_reg_types(req);
 
-   jit_dump(req->func);
+   if (!osr && opt_get_verbose(OPT_JIT_VERBOSE, req->name)) {
+      jit_dump(req->func);
+      cgen_dump_reg_types(req);
+   }
 
    cgen_block_t *cgb = req->blocks;
 
@@ -1028,7 +1274,8 @@ static void cgen_module(cgen_req_t *req)
       cgen_ir(req, cgb, &(req->func->irbuf[i]));
 
       if (i == cgb->source->last) {
-         if (cgb->source->aborts)
+         if (cgb->source->aborts
+             && LLVMGetBasicBlockTerminator(cgb->bbref) == NULL)
             LLVMBuildUnreachable(req->builder);
 
          if (LLVMGetBasicBlockTerminator(cgb->bbref) == NULL) {
@@ -1042,9 +1289,11 @@ static void cgen_module(cgen_req_t *req)
       }
    }
 
-   LLVMValueRef flags0_in[] = { llvm_int1(req, false) };
-   LLVMBasicBlockRef flags0_bb[] = { entry_bb };
-   LLVMAddIncoming(req->blocks[0].inflags, flags0_in, flags0_bb, 1);
+   if (!osr) {
+      LLVMValueRef flags0_in[] = { llvm_int1(req, false) };
+      LLVMBasicBlockRef flags0_bb[] = { entry_bb };
+      LLVMAddIncoming(req->blocks[0].inflags, flags0_in, flags0_bb, 1);
+   }
 
    LLVMValueRef *phi_in LOCAL = xmalloc_array(maxin, sizeof(LLVMValueRef));
    LLVMBasicBlockRef *phi_bb LOCAL =
@@ -1076,6 +1325,13 @@ static void cgen_module(cgen_req_t *req)
       }
    }
 
+   if (osr)
+      cgen_osr_entry(req, entry_bb);
+   else {
+      LLVMPositionBuilderAtEnd(req->builder, entry_bb);
+      LLVMBuildBr(req->builder, req->blocks[0].bbref);
+   }
+
    for (int i = 0; i < cfg->nblocks; i++) {
       cgen_block_t *cgb = &(req->blocks[i]);
       free(cgb->inregs);
@@ -1083,9 +1339,6 @@ static void cgen_module(cgen_req_t *req)
       cgb->inregs = cgb->outregs = NULL;
    }
 
-   LLVMPositionBuilderAtEnd(req->builder, entry_bb);
-   LLVMBuildBr(req->builder, req->blocks[0].bbref);
-
    jit_free_cfg(req->func);
    req->cfg = cfg = NULL;
 
@@ -1094,13 +1347,74 @@ static void cgen_module(cgen_req_t *req)
 
    free(req->regtypes);
    req->regtypes = NULL;
+}
+
+static void cgen_module(cgen_req_t *req)
+{
+   req->module  = LLVMModuleCreateWithNameInContext(req->name, req->context);
+   req->builder = LLVMCreateBuilderInContext(req->context);
+
+   char *triple = LLVMGetTargetMachineTriple(req->target);
+   LLVMSetTarget(req->module, triple);
+   LLVMDisposeMessage(triple);
+
+   LLVMTargetDataRef data_ref = LLVMCreateTargetDataLayout(req->target);
+   LLVMSetModuleDataLayout(req->module, data_ref);
+
+   req->types[LLVM_VOID]   = LLVMVoidTypeInContext(req->context);
+   req->types[LLVM_PTR]    = LLVMPointerTypeInContext(req->context, 0);
+   req->types[LLVM_INT1]   = LLVMInt1TypeInContext(req->context);
+   req->types[LLVM_INT8]   = LLVMInt8TypeInContext(req->context);
+   req->types[LLVM_INT16]  = LLVMInt16TypeInContext(req->context);
+   req->types[LLVM_INT32]  = LLVMInt32TypeInContext(req->context);
+   req->types[LLVM_INT64]  = LLVMInt64TypeInContext(req->context);
+   req->types[LLVM_INTPTR] = LLVMIntPtrTypeInContext(req->context, data_ref);
+
+   LLVMTypeRef atypes[] = { req->types[LLVM_PTR], req->types[LLVM_PTR] };
+   req->types[LLVM_ENTRY_FN] = LLVMFunctionType(req->types[LLVM_INT1], atypes,
+                                                ARRAY_LEN(atypes), false);
+
+   LLVMTypeRef osr_atypes[] = {
+      req->types[LLVM_PTR],
+      req->types[LLVM_PTR],
+      req->types[LLVM_PTR]
+   };
+   req->types[LLVM_OSR_FN] = LLVMFunctionType(req->types[LLVM_INT1],
+                                              osr_atypes,
+                                              ARRAY_LEN(osr_atypes), false);
+
+   LLVMTypeRef exit_atypes[] = {
+      req->types[LLVM_INT32],
+      req->types[LLVM_PTR]
+   };
+   req->types[LLVM_EXIT_FN] = LLVMFunctionType(req->types[LLVM_VOID],
+                                               exit_atypes,
+                                               ARRAY_LEN(exit_atypes), false);
+
+   // Functions containing loops get a second entry point which the
+   // interpreter can call part way through execution: this is kept
+   // separate so the extra entry edges do not pessimise the normal
+   // entry point
+   if ((req->osr = cgen_has_loops(req->func))) {
+      char *osr_name LOCAL = xasprintf("%s$osr", req->name);
+      cgen_function(req, osr_name, true);
+   }
+
+   cgen_function(req, req->name, false);
 
    LLVMDisposeBuilder(req->builder);
    req->builder = NULL;
 
+   if (req->debuginfo != NULL) {
+      LLVMDIBuilderFinalize(req->debuginfo);
+      LLVMDisposeDIBuilder(req->debuginfo);
+      req->debuginfo = NULL;
+   }
+
    LLVMDisposeTargetData(data_ref);
 
-   LLVMDumpModule(req->module);
+   if (opt_get_verbose(OPT_JIT_VERBOSE, req->name))
+      LLVMDumpModule(req->module);
 
 #ifdef DEBUG
    if (LLVMVerifyModule(req->module, LLVMPrintMessageAction, NULL))
@@ -1127,7 +1441,78 @@ static void cgen_optimise(cgen_req_t *req)
    LLVMFinalizeFunctionPassManager(fpm);
    LLVMDisposePassManager(fpm);
 
-   LLVMDumpModule(req->module);
+   if (opt_get_verbose(OPT_JIT_VERBOSE, req->name))
+      LLVMDumpModule(req->module);
+}
+
+static LLVMOrcObjectLayerRef jit_llvm_object_layer(
+   void *ctx, LLVMOrcExecutionSessionRef es, const char *triple)
+{
+   LLVMOrcObjectLayerRef layer =
+      LLVMOrcCreateRTDyldObjectLinkingLayerWithSectionMemoryManager(es);
+
+   // Writes a jitdump file which perf inject can merge with the samples
+   // including the line tables: returns NULL if LLVM was built without
+   // perf support
+   LLVMJITEventListenerRef listener = LLVMCreatePerfJITEventListener();
+   if (listener != NULL)
+      LLVMOrcRTDyldObjectLinkingLayerRegisterJITEventListener(layer, listener);
+
+   return layer;
+}
+
+static LLVMErrorRef jit_llvm_object_transform(void *ctx,
+                                              LLVMMemoryBufferRef *obj)
+{
+   char *error = NULL;
+   LLVMBinaryRef binary = LLVMCreateBinary(*obj, NULL, &error);
+   if (binary == NULL) {
+      warnf("cannot read generated object: %s", error);
+      LLVMDisposeMessage(error);
+      return LLVMErrorSuccess;
+   }
+
+   lljit_state_t *state = ctx;
+
+   for (int i = 0; i < last_symbols.count; i++)
+      free(last_symbols.items[i].name);
+   ACLEAR(last_symbols);
+
+   // Each module defines the function itself and possibly an OSR entry
+   // point so record the size of every symbol by name
+   LLVMSymbolIteratorRef it = LLVMObjectFileCopySymbolIterator(binary);
+   for (; !LLVMObjectFileIsSymbolIteratorAtEnd(binary, it);
+        LLVMMoveToNextSymbol(it)) {
+      const char *name = LLVMGetSymbolName(it);
+      if (state->prefix != '\0' && name[0] == state->prefix)
+         name++;
+
+      const symbol_size_t sym = { xstrdup(name), LLVMGetSymbolSize(it) };
+      APUSH(last_symbols, sym);
+   }
+
+   LLVMDisposeSymbolIterator(it);
+   LLVMDisposeBinary(binary);
+
+   return LLVMErrorSuccess;
+}
+
+static void jit_llvm_perf_map(lljit_state_t *state, const char *name,
+                              LLVMOrcJITTargetAddress addr)
+{
+   uint64_t size = 0;
+   for (int i = 0; i < last_symbols.count; i++) {
+      if (strcmp(last_symbols.items[i].name, name) == 0) {
+         size = last_symbols.items[i].size;
+         break;
+      }
+   }
+
+   SCOPED_LOCK(state->perflock);
+
+   fprintf(state->perfmap, "%"PRIx64" %"PRIx64" %s\n", (uint64_t)addr,
+           size, name);
+   fflush(state->perfmap);
 }
 
 static void *jit_llvm_init(void)
@@ -1139,17 +1524,33 @@ static void *jit_llvm_init(void)
 
    LLVMOrcLLJITBuilderRef builder = LLVMOrcCreateLLJITBuilder();
 
+   if (opt_get_int(OPT_PERF_MAP))
+      LLVMOrcLLJITBuilderSetObjectLinkingLayerCreator(
+         builder, jit_llvm_object_layer, state);
+
    LLVM_CHECK(LLVMOrcCreateLLJIT, &state->jit, builder);
 
+   if (opt_get_int(OPT_PERF_MAP)) {
+      char path[64];
+      checked_sprintf(path, sizeof(path), "/tmp/perf-%d.map", getpid());
+
+      if ((state->perfmap = fopen(path, "w")) == NULL)
+         fatal_errno("%s", path);
+
+      LLVMOrcObjectTransformLayerSetTransform(
+         LLVMOrcLLJITGetObjTransformLayer(state->jit),
+         jit_llvm_object_transform, state);
+   }
+
    state->session = LLVMOrcLLJITGetExecutionSession(state->jit);
    state->dylib   = LLVMOrcLLJITGetMainJITDylib(state->jit);
    state->context = LLVMOrcCreateNewThreadSafeContext();
 
-   const char prefix = LLVMOrcLLJITGetGlobalPrefix(state->jit);
+   state->prefix = LLVMOrcLLJITGetGlobalPrefix(state->jit);
 
    LLVMOrcDefinitionGeneratorRef gen_ref;
    LLVM_CHECK(LLVMOrcCreateDynamicLibrarySearchGeneratorForProcess,
-              &gen_ref, prefix, NULL, NULL);
+              &gen_ref, state->prefix, NULL, NULL);
 
    LLVMOrcJITDylibAddGenerator(state->dylib, gen_ref);
 
@@ -1162,8 +1563,6 @@ static void jit_llvm_cgen(jit_t *j, jit_handle_t handle, void *context)
 
    jit_func_t *f = jit_get_func(j, handle);
 
-   printf("LLVM compile %s\n", istr(f->name));
-
    static __thread LLVMTargetMachineRef tm_ref = NULL;
    if (tm_ref == NULL) {
       char *def_triple = LLVMGetDefaultTargetTriple();
@@ -1199,7 +1598,23 @@ static void jit_llvm_cgen(jit_t *j, jit_handle_t handle, void *context)
    LLVMOrcJITTargetAddress addr;
    LLVM_CHECK(LLVMOrcLLJITLookup, state->jit, &addr, req.name);
 
-   printf("%s at %p\n", req.name, (void *)addr);
+   if (opt_get_verbose(OPT_JIT_VERBOSE, req.name))
+      debugf("%s at %p", req.name, (void *)addr);
+
+   if (state->perfmap != NULL)
+      jit_llvm_perf_map(state, req.name, addr);
+
+   if (req.osr) {
+      char *osr_name LOCAL = xasprintf("%s$osr", req.name);
+
+      LLVMOrcJITTargetAddress osr_addr;
+      LLVM_CHECK(LLVMOrcLLJITLookup, state->jit, &osr_addr, osr_name);
+
+      if (state->perfmap != NULL)
+         jit_llvm_perf_map(state, osr_name, osr_addr);
+
+      atomic_store(&f->osr_entry, (jit_osr_fn_t)osr_addr);
+   }
 
    atomic_store(&f->entry, (jit_entry_fn_t)addr);
 
@@ -1211,6 +1626,9 @@ static void jit_llvm_cleanup(void *context)
 {
    lljit_state_t *state = context;
 
+   if (state->perfmap != NULL)
+      fclose(state->perfmap);
+
    LLVMOrcDisposeThreadSafeContext(state->context);
    LLVMOrcDisposeLLJIT(state->jit);
 
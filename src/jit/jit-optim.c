@@ -16,10 +16,13 @@
 //
 
 #include "util.h"
+#include "ident.h"
 #include "jit/jit-priv.h"
+#include "opt.h"
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Control flow graph construction
@@ -45,13 +48,39 @@ static bool cfg_will_abort(jit_ir_t *ir)
       return ir->op == J_TRAP;
 }
 
-static void cfg_add_edge(jit_cfg_t *cfg, jit_block_t *from, jit_block_t *to)
+static void cfg_push_edge(jit_edge_list_t *list, unsigned edge)
 {
-   assert(from->out.count < 4);
-   assert(to->in.count < 4);
+   if (list->count < ARRAY_LEN(list->edges))
+      list->edges[list->count++] = edge;
+   else if (list->count == ARRAY_LEN(list->edges)) {
+      unsigned *external = xmalloc_array(16, sizeof(unsigned));
+      memcpy(external, list->edges, sizeof(list->edges));
+      external[list->count++] = edge;
+
+      list->external = external;
+      list->max      = 16;
+   }
+   else {
+      if (list->count == list->max) {
+         list->max *= 2;
+         list->external =
+            xrealloc_array(list->external, list->max, sizeof(unsigned));
+      }
 
-   from->out.edges[from->out.count++] = to - cfg->blocks;
-   to->in.edges[to->in.count++] = from - cfg->blocks;
+      list->external[list->count++] = edge;
+   }
+}
+
+static void cfg_free_edges(jit_edge_list_t *list)
+{
+   if (list->count > ARRAY_LEN(list->edges))
+      free(list->external);
+}
+
+static void cfg_add_edge(jit_cfg_t *cfg, jit_block_t *from, jit_block_t *to)
+{
+   cfg_push_edge(&(from->out), to - cfg->blocks);
+   cfg_push_edge(&(to->in), from - cfg->blocks);
 }
 
 static jit_reg_t cfg_get_reg(jit_value_t value)
@@ -193,6 +222,8 @@ void jit_free_cfg(jit_func_t *f)
          mask_free(&b->livein);
          mask_free(&b->liveout);
          mask_free(&b->varkill);
+         cfg_free_edges(&b->in);
+         cfg_free_edges(&b->out);
       }
 
       free(f->cfg);
@@ -202,10 +233,15 @@ void jit_free_cfg(jit_func_t *f)
 
 jit_block_t *jit_block_for(jit_cfg_t *cfg, int pos)
 {
-   // TODO: do binary search
-   for (int i = 0; i < cfg->nblocks; i++) {
-      jit_block_t *bb = &(cfg->blocks[i]);
-      if (pos >= bb->first && pos <= bb->last)
+   int low = 0, high = cfg->nblocks - 1;
+   while (low <= high) {
+      const int mid = (low + high) / 2;
+      jit_block_t *bb = &(cfg->blocks[mid]);
+      if (pos < bb->first)
+         high = mid - 1;
+      else if (pos > bb->last)
+         low = mid + 1;
+      else
          return bb;
    }
 
@@ -214,6 +250,812 @@ jit_block_t *jit_block_for(jit_cfg_t *cfg, int pos)
 
 int jit_get_edge(jit_edge_list_t *list, int nth)
 {
-   assert(nth < 4);
-   return list->edges[nth];
+   assert(nth < list->count);
+   if (list->count > ARRAY_LEN(list->edges))
+      return list->external[nth];
+   else
+      return list->edges[nth];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Optimisation passes
+
+typedef struct {
+   jit_func_t *func;
+   bit_mask_t  dead;
+   bool        changed;
+} optim_t;
+
+typedef void (*optim_pass_fn_t)(optim_t *);
+
+typedef enum {
+   EXT_NONE, EXT_SIGNED, EXT_UNSIGNED
+} optim_ext_t;
+
+typedef struct {
+   jit_value_t value;
+   unsigned    block;
+   unsigned    srcdef;
+} optim_known_t;
+
+typedef struct {
+   int64_t      offset;
+   jit_size_t   size;
+   optim_ext_t  ext;
+   jit_value_t  value;
+   unsigned     srcdef;
+} optim_slot_t;
+
+#define MAX_SLOTS 32
+
+static jit_reg_t optim_def(jit_ir_t *ir)
+{
+   switch (ir->op) {
+   case MACRO_COPY:
+   case MACRO_BZERO:
+      return JIT_REG_INVALID;   // Result register holds the byte count
+   default:
+      return ir->result;
+   }
+}
+
+static int optim_uses(jit_ir_t *ir, jit_reg_t *uses)
+{
+   int count = 0;
+
+   if ((uses[count] = cfg_get_reg(ir->arg1)) != JIT_REG_INVALID)
+      count++;
+   if ((uses[count] = cfg_get_reg(ir->arg2)) != JIT_REG_INVALID)
+      count++;
+
+   if (ir->op == MACRO_COPY || ir->op == MACRO_BZERO)
+      uses[count++] = ir->result;
+
+   return count;
+}
+
+static bool optim_sets_flags(jit_ir_t *ir)
+{
+   switch (ir->op) {
+   case J_CMP:
+   case J_FCMP:
+      return true;
+   case J_ADD:
+   case J_SUB:
+   case J_MUL:
+      return ir->cc != JIT_CC_NONE;
+   default:
+      return false;
+   }
+}
+
+static bool optim_reads_flags(jit_ir_t *ir)
+{
+   switch (ir->op) {
+   case J_CSET:
+   case J_CSEL:
+      return true;
+   case J_JUMP:
+      return ir->cc == JIT_CC_T || ir->cc == JIT_CC_F;
+   default:
+      return false;
+   }
+}
+
+static bool optim_is_pure(jit_ir_t *ir)
+{
+   // True if the instruction has no effect other than writing its
+   // result register and possibly the flags
+   switch (ir->op) {
+   case J_RECV:
+   case J_ADD:
+   case J_SUB:
+   case J_MUL:
+   case J_FADD:
+   case J_FSUB:
+   case J_FMUL:
+   case J_FDIV:
+   case J_AND:
+   case J_OR:
+   case J_XOR:
+   case J_NEG:
+   case J_FNEG:
+   case J_NOT:
+   case J_MOV:
+   case J_LEA:
+   case J_LOAD:
+   case J_ULOAD:
+   case J_CMP:
+   case J_FCMP:
+   case J_CSET:
+   case J_CSEL:
+   case J_SCVTF:
+   case J_FCVTNS:
+   case MACRO_EXP:
+   case MACRO_FEXP:
+   case MACRO_GETPRIV:
+      return true;
+   default:
+      return false;
+   }
+}
+
+static bool optim_clobbers_memory(jit_ir_t *ir)
+{
+   switch (ir->op) {
+   case J_STORE:
+      return ir->arg2.kind != JIT_ADDR_FRAME;
+   case J_CALL:
+   case MACRO_COPY:
+   case MACRO_BZERO:
+   case MACRO_EXIT:
+   case MACRO_FFICALL:
+      return true;
+   default:
+      return false;
+   }
+}
+
+static void optim_make_mov(jit_ir_t *ir, jit_value_t value)
+{
+   ir->op   = J_MOV;
+   ir->size = JIT_SZ_UNSPEC;
+   ir->cc   = JIT_CC_NONE;
+   ir->arg1 = value;
+   ir->arg2.kind = JIT_VALUE_INVALID;
+}
+
+static inline jit_value_t optim_int64(int64_t value)
+{
+   return (jit_value_t){ .kind = JIT_VALUE_INT64, .int64 = value };
+}
+
+static int64_t optim_extend(int64_t value, jit_size_t size, optim_ext_t ext)
+{
+   switch (size) {
+   case JIT_SZ_8:
+      return ext == EXT_SIGNED ? (int8_t)value : (uint8_t)value;
+   case JIT_SZ_16:
+      return ext == EXT_SIGNED ? (int16_t)value : (uint16_t)value;
+   case JIT_SZ_32:
+      return ext == EXT_SIGNED ? (int32_t)value : (uint32_t)value;
+   default:
+      return value;
+   }
+}
+
+static void optim_compact(optim_t *o)
+{
+   jit_func_t *f = o->func;
+
+   unsigned *map = xmalloc_array(f->nirs + 1, sizeof(unsigned));
+
+   unsigned pos = 0;
+   for (int i = 0; i < f->nirs; i++) {
+      map[i] = pos;
+      if (!mask_test(&o->dead, i))
+         pos++;
+   }
+   map[f->nirs] = pos;
+
+   // Labels on deleted instructions move to the next live one
+   bool target = false;
+   for (int i = 0; i < f->nirs; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+      target |= ir->target;
+
+      if (!mask_test(&o->dead, i)) {
+         if (ir->arg1.kind == JIT_VALUE_LABEL) {
+            assert(map[ir->arg1.label] < pos);
+            ir->arg1.label = map[ir->arg1.label];
+         }
+
+         ir->target = target;
+         f->irbuf[map[i]] = *ir;
+         target = false;
+      }
+   }
+
+   f->nirs = pos;
+   free(map);
+}
+
+static void optim_run_pass(jit_func_t *f, const char *name,
+                           optim_pass_fn_t fn, bool verbose)
+{
+   optim_t o = { .func = f };
+   mask_init(&o.dead, f->nirs);
+
+   (*fn)(&o);
+
+   if (o.changed) {
+      jit_free_cfg(f);
+      optim_compact(&o);
+
+      if (verbose) {
+         printf(";; after %s pass\n", name);
+         jit_dump(f);
+      }
+   }
+
+   mask_free(&o.dead);
+}
+
+static void optim_propagate(optim_t *o)
+{
+   // Local constant and copy propagation, constant folding, and
+   // folding of branches on flags with a known value
+
+   jit_func_t *f = o->func;
+   jit_cfg_t *cfg = jit_get_cfg(f);
+
+   optim_known_t *known = xcalloc_array(f->nregs, sizeof(optim_known_t));
+   unsigned *defat = xcalloc_array(f->nregs, sizeof(unsigned));
+   unsigned tick = 0;
+
+   for (int i = 0; i < cfg->nblocks; i++) {
+      jit_block_t *b = &(cfg->blocks[i]);
+      const unsigned stamp = i + 1;
+      int flags = -1;   // Unknown
+
+      for (int j = b->first; j <= b->last; j++) {
+         jit_ir_t *ir = &(f->irbuf[j]);
+
+         jit_value_t *args[] = { &(ir->arg1), &(ir->arg2) };
+         for (int k = 0; k < ARRAY_LEN(args); k++) {
+            jit_value_t *arg = args[k];
+            if (arg->kind != JIT_VALUE_REG && arg->kind != JIT_ADDR_REG)
+               continue;
+
+            optim_known_t *kn = &(known[arg->reg]);
+            if (kn->block != stamp)
+               continue;
+            else if (kn->value.kind == JIT_VALUE_REG) {
+               if (defat[kn->value.reg] != kn->srcdef)
+                  continue;   // Source redefined since the copy
+               arg->reg = kn->value.reg;
+               o->changed = true;
+            }
+            else if (arg->kind == JIT_VALUE_REG) {
+               *arg = kn->value;
+               o->changed = true;
+            }
+         }
+
+         const bool const1 = ir->arg1.kind == JIT_VALUE_INT64;
+         const bool const2 = ir->arg2.kind == JIT_VALUE_INT64;
+         const uint64_t a = ir->arg1.int64, b = ir->arg2.int64;
+
+         switch (ir->op) {
+         case J_ADD:
+            if (const1 && const2 && ir->cc == JIT_CC_NONE)
+               optim_make_mov(ir, optim_int64(a + b));
+            break;
+         case J_SUB:
+            if (const1 && const2 && ir->cc == JIT_CC_NONE)
+               optim_make_mov(ir, optim_int64(a - b));
+            break;
+         case J_MUL:
+            if (const1 && const2 && ir->cc == JIT_CC_NONE)
+               optim_make_mov(ir, optim_int64(a * b));
+            break;
+         case J_DIV:
+            if (const1 && const2 && b != 0 && (int64_t)b != -1)
+               optim_make_mov(ir, optim_int64((int64_t)a / (int64_t)b));
+            break;
+         case J_REM:
+            if (const1 && const2 && b != 0 && (int64_t)b != -1)
+               optim_make_mov(ir, optim_int64((int64_t)a % (int64_t)b));
+            break;
+         case J_AND:
+            if (const1 && const2)
+               optim_make_mov(ir, optim_int64(a && b));
+            break;
+         case J_OR:
+            if (const1 && const2)
+               optim_make_mov(ir, optim_int64(a || b));
+            break;
+         case J_XOR:
+            if (const1 && const2)
+               optim_make_mov(ir, optim_int64(a ^ b));
+            break;
+         case J_NEG:
+            if (const1)
+               optim_make_mov(ir, optim_int64(-a));
+            break;
+         case J_NOT:
+            if (const1)
+               optim_make_mov(ir, optim_int64(!a));
+            break;
+         case J_CSET:
+            if (flags != -1)
+               optim_make_mov(ir, optim_int64(flags));
+            break;
+         case J_CSEL:
+            if (flags != -1)
+               optim_make_mov(ir, flags ? ir->arg1 : ir->arg2);
+            break;
+         case J_JUMP:
+            if (flags == -1 || !optim_reads_flags(ir))
+               break;
+            else if (flags == (ir->cc == JIT_CC_T))
+               ir->cc = JIT_CC_NONE;
+            else
+               mask_set(&o->dead, j);
+            o->changed = true;
+            break;
+         default:
+            break;
+         }
+
+         if (ir->op == J_MOV && ir->arg1.kind == JIT_VALUE_REG
+             && ir->arg1.reg == ir->result) {
+            mask_set(&o->dead, j);   // Moving register to itself
+            o->changed = true;
+            continue;
+         }
+
+         if (ir->op == J_CMP && const1 && const2) {
+            const int64_t sa = a, sb = b;
+            switch (ir->cc) {
+            case JIT_CC_EQ: flags = (sa == sb); break;
+            case JIT_CC_NE: flags = (sa != sb); break;
+            case JIT_CC_LT: flags = (sa < sb); break;
+            case JIT_CC_GT: flags = (sa > sb); break;
+            case JIT_CC_LE: flags = (sa <= sb); break;
+            case JIT_CC_GE: flags = (sa >= sb); break;
+            default: flags = 0; break;
+            }
+         }
+         else if (optim_sets_flags(ir))
+            flags = -1;
+
+         const jit_reg_t def = optim_def(ir);
+         if (def == JIT_REG_INVALID)
+            continue;
+
+         defat[def] = ++tick;
+
+         if (ir->op == J_MOV && (ir->arg1.kind == JIT_VALUE_INT64
+                                 || ir->arg1.kind == JIT_VALUE_REG)) {
+            known[def].value = ir->arg1;
+            known[def].block = stamp;
+            if (ir->arg1.kind == JIT_VALUE_REG)
+               known[def].srcdef = defat[ir->arg1.reg];
+         }
+         else
+            known[def].block = 0;
+      }
+   }
+
+   free(known);
+   free(defat);
+}
+
+static void optim_memory(optim_t *o)
+{
+   // Forward values stored to or loaded from frame slots to later
+   // loads within the same basic block and remove stores which do not
+   // change the contents of the slot
+
+   jit_func_t *f = o->func;
+   jit_cfg_t *cfg = jit_get_cfg(f);
+
+   // Stores to frame slots which are never loaded are dead unless the
+   // address of the frame escapes
+   bit_mask_t loaded;
+   mask_init(&loaded, MAX(f->framesz, 1));
+
+   bool escapes = false;
+   for (int i = 0; i < f->nirs && !escapes; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+      if ((ir->op == J_LOAD || ir->op == J_ULOAD)
+          && ir->arg1.kind == JIT_ADDR_FRAME)
+         mask_set_range(&loaded, ir->arg1.int64, 1 << ir->size);
+      else if (ir->op == J_STORE && ir->arg2.kind == JIT_ADDR_FRAME)
+         escapes = ir->arg1.kind == JIT_ADDR_FRAME;
+      else
+         escapes = ir->arg1.kind == JIT_ADDR_FRAME
+            || ir->arg2.kind == JIT_ADDR_FRAME;
+   }
+
+   for (int i = 0; i < f->nirs && !escapes; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+      if (ir->op != J_STORE || ir->arg2.kind != JIT_ADDR_FRAME)
+         continue;
+
+      bool live = false;
+      for (int j = 0; j < 1 << ir->size; j++)
+         live |= mask_test(&loaded, ir->arg2.int64 + j);
+
+      if (!live) {
+         mask_set(&o->dead, i);
+         o->changed = true;
+      }
+   }
+
+   mask_free(&loaded);
+
+   unsigned *defat = xcalloc_array(f->nregs, sizeof(unsigned));
+   optim_ext_t *regext = xcalloc_array(f->nregs, sizeof(optim_ext_t));
+   jit_size_t *regsize = xcalloc_array(f->nregs, sizeof(jit_size_t));
+   unsigned tick = 0;
+
+   optim_slot_t slots[MAX_SLOTS];
+
+   for (int i = 0; i < cfg->nblocks; i++) {
+      jit_block_t *b = &(cfg->blocks[i]);
+      int nslots = 0;
+      const unsigned base = tick + 1;
+
+      for (int j = b->first; j <= b->last; j++) {
+         jit_ir_t *ir = &(f->irbuf[j]);
+
+         if (mask_test(&o->dead, j))
+            continue;
+         else if (optim_clobbers_memory(ir))
+            nslots = 0;
+         else if (ir->op == J_STORE) {
+            const int64_t offset = ir->arg2.int64;
+            const int bytes = 1 << ir->size;
+
+            optim_slot_t *match = NULL;
+            for (int k = 0; k < nslots; k++) {
+               optim_slot_t *s = &(slots[k]);
+               if (s->offset == offset && s->size == ir->size)
+                  match = s;
+               else if (s->offset < offset + bytes
+                        && offset < s->offset + (1 << s->size))
+                  slots[k--] = slots[--nslots];   // Overlaps
+            }
+
+            if (match != NULL && match->value.kind == ir->arg1.kind) {
+               bool same = false;
+               if (ir->arg1.kind == JIT_VALUE_INT64)
+                  same = optim_extend(match->value.int64, ir->size, EXT_NONE)
+                     == optim_extend(ir->arg1.int64, ir->size, EXT_NONE);
+               else if (ir->arg1.kind == JIT_VALUE_REG)
+                  same = match->value.reg == ir->arg1.reg
+                     && match->srcdef == defat[ir->arg1.reg];
+
+               if (same) {
+                  mask_set(&o->dead, j);
+                  o->changed = true;
+                  continue;
+               }
+            }
+
+            if (match != NULL)
+               *match = slots[--nslots];   // Replaced below
+
+            if (nslots == MAX_SLOTS)
+               continue;
+            else if (ir->arg1.kind != JIT_VALUE_REG
+                     && ir->arg1.kind != JIT_VALUE_INT64)
+               continue;
+
+            optim_slot_t *s = &(slots[nslots++]);
+            s->offset = offset;
+            s->size   = ir->size;
+            s->value  = ir->arg1;
+            s->ext    = EXT_NONE;
+
+            if (ir->arg1.kind == JIT_VALUE_REG) {
+               const jit_reg_t reg = ir->arg1.reg;
+               s->srcdef = defat[reg];
+               if (defat[reg] >= base && regsize[reg] == ir->size)
+                  s->ext = regext[reg];
+            }
+         }
+         else if ((ir->op == J_LOAD || ir->op == J_ULOAD)
+                  && ir->arg1.kind == JIT_ADDR_FRAME) {
+            const optim_ext_t ext =
+               ir->op == J_LOAD ? EXT_SIGNED : EXT_UNSIGNED;
+            const int64_t offset = ir->arg1.int64;
+
+            optim_slot_t *match = NULL;
+            for (int k = 0; k < nslots && match == NULL; k++) {
+               optim_slot_t *s = &(slots[k]);
+               if (s->offset != offset || s->size != ir->size)
+                  continue;
+               else if (s->value.kind == JIT_VALUE_INT64)
+                  match = s;
+               else if (s->value.kind != JIT_VALUE_REG)
+                  continue;
+               else if (defat[s->value.reg] != s->srcdef)
+                  continue;   // Register redefined
+               else if (ir->size == JIT_SZ_64 || s->ext == ext)
+                  match = s;
+            }
+
+            const jit_reg_t result = ir->result;
+
+            if (match != NULL) {
+               jit_value_t value = match->value;
+               if (value.kind == JIT_VALUE_INT64)
+                  value.int64 = optim_extend(value.int64, ir->size, ext);
+
+               const jit_size_t size = ir->size;
+               optim_make_mov(ir, value);
+               o->changed = true;
+
+               defat[result] = ++tick;
+               regext[result] = ext;
+               regsize[result] = size;
+               continue;
+            }
+
+            defat[result] = ++tick;
+            regext[result] = ext;
+            regsize[result] = ir->size;
+
+            if (nslots < MAX_SLOTS) {
+               optim_slot_t *s = &(slots[nslots++]);
+               s->offset = offset;
+               s->size   = ir->size;
+               s->ext    = ext;
+               s->value  = (jit_value_t){
+                  .kind = JIT_VALUE_REG,
+                  .reg = result
+               };
+               s->srcdef = defat[result];
+            }
+            continue;
+         }
+
+         const jit_reg_t def = optim_def(ir);
+         if (def == JIT_REG_INVALID)
+            continue;
+
+         defat[def] = ++tick;
+
+         // Overflow checked arithmetic leaves the result extended
+         // from the operation size
+         switch (ir->op) {
+         case J_ADD:
+         case J_SUB:
+         case J_MUL:
+            regsize[def] = ir->size;
+            if (ir->cc == JIT_CC_O)
+               regext[def] = EXT_SIGNED;
+            else if (ir->cc == JIT_CC_C)
+               regext[def] = EXT_UNSIGNED;
+            else
+               regext[def] = EXT_NONE;
+            break;
+         default:
+            regext[def] = EXT_NONE;
+            break;
+         }
+      }
+   }
+
+   free(defat);
+   free(regext);
+   free(regsize);
+}
+
+static void optim_branches(optim_t *o)
+{
+   // Delete unreachable blocks, jumps to the following instruction,
+   // and thread jumps to unconditional jumps
+
+   jit_func_t *f = o->func;
+   jit_cfg_t *cfg = jit_get_cfg(f);
+
+   bit_mask_t reached;
+   mask_init(&reached, cfg->nblocks);
+
+   int *worklist = xmalloc_array(cfg->nblocks, sizeof(int));
+   int wptr = 0;
+
+   mask_set(&reached, 0);
+   worklist[wptr++] = 0;
+
+   while (wptr > 0) {
+      jit_block_t *b = &(cfg->blocks[worklist[--wptr]]);
+      for (int i = 0; i < b->out.count; i++) {
+         const int succ = jit_get_edge(&b->out, i);
+         if (!mask_test(&reached, succ)) {
+            mask_set(&reached, succ);
+            worklist[wptr++] = succ;
+         }
+      }
+   }
+
+   for (int i = 0; i < cfg->nblocks; i++) {
+      jit_block_t *b = &(cfg->blocks[i]);
+
+      if (!mask_test(&reached, i)) {
+         for (int j = b->first; j <= b->last; j++)
+            mask_set(&o->dead, j);
+         o->changed = true;
+         continue;
+      }
+
+      jit_ir_t *ir = &(f->irbuf[b->last]);
+      if (ir->op != J_JUMP)
+         continue;
+
+      for (int limit = 16; limit > 0; limit--) {
+         jit_ir_t *dest = &(f->irbuf[ir->arg1.label]);
+         if (dest->op != J_JUMP || dest->cc != JIT_CC_NONE
+             || dest->arg1.label == ir->arg1.label)
+            break;
+
+         ir->arg1.label = dest->arg1.label;
+         o->changed = true;
+      }
+
+      if (ir->arg1.label == b->last + 1) {
+         mask_set(&o->dead, b->last);
+         o->changed = true;
+      }
+   }
+
+   mask_free(&reached);
+   free(worklist);
+}
+
+static void optim_dead_code(optim_t *o)
+{
+   // Remove instructions whose result register and flags are never
+   // read using a global liveness analysis
+
+   jit_func_t *f = o->func;
+   jit_cfg_t *cfg = jit_get_cfg(f);
+
+   bit_mask_t *livein = xcalloc_array(cfg->nblocks, sizeof(bit_mask_t));
+   bit_mask_t *liveout = xcalloc_array(cfg->nblocks, sizeof(bit_mask_t));
+   bit_mask_t *gen = xcalloc_array(cfg->nblocks, sizeof(bit_mask_t));
+   bit_mask_t *kill = xcalloc_array(cfg->nblocks, sizeof(bit_mask_t));
+   bool *flagsin = xcalloc_array(cfg->nblocks, sizeof(bool));
+   bool *flagsout = xcalloc_array(cfg->nblocks, sizeof(bool));
+   bool *flagskill = xcalloc_array(cfg->nblocks, sizeof(bool));
+
+   for (int i = 0; i < cfg->nblocks; i++) {
+      mask_init(&livein[i], f->nregs);
+      mask_init(&liveout[i], f->nregs);
+      mask_init(&gen[i], f->nregs);
+      mask_init(&kill[i], f->nregs);
+   }
+
+   bit_mask_t live, tmp;
+   mask_init(&live, f->nregs);
+   mask_init(&tmp, f->nregs);
+
+   bool removed;
+   do {
+      removed = false;
+
+      for (int i = 0; i < cfg->nblocks; i++) {
+         jit_block_t *b = &(cfg->blocks[i]);
+         mask_clearall(&gen[i]);
+         mask_clearall(&kill[i]);
+         mask_clearall(&livein[i]);
+         mask_clearall(&liveout[i]);
+         flagsin[i] = flagsout[i] = flagskill[i] = false;
+
+         for (int j = b->first; j <= b->last; j++) {
+            if (mask_test(&o->dead, j))
+               continue;
+
+            jit_ir_t *ir = &(f->irbuf[j]);
+
+            jit_reg_t uses[3];
+            const int nuses = optim_uses(ir, uses);
+            for (int k = 0; k < nuses; k++) {
+               if (!mask_test(&kill[i], uses[k]))
+                  mask_set(&gen[i], uses[k]);
+            }
+
+            if (optim_reads_flags(ir) && !flagskill[i])
+               flagsin[i] = true;
+            if (optim_sets_flags(ir))
+               flagskill[i] = true;
+
+            const jit_reg_t def = optim_def(ir);
+            if (def != JIT_REG_INVALID)
+               mask_set(&kill[i], def);
+         }
+
+         mask_copy(&livein[i], &gen[i]);
+      }
+
+      bool changed;
+      do {
+         changed = false;
+
+         for (int i = cfg->nblocks - 1; i >= 0; i--) {
+            jit_block_t *b = &(cfg->blocks[i]);
+
+            mask_clearall(&tmp);
+            bool fout = false;
+            for (int j = 0; j < b->out.count; j++) {
+               const int succ = jit_get_edge(&b->out, j);
+               mask_union(&tmp, &livein[succ]);
+               fout |= flagsin[succ];
+            }
+
+            if (!mask_eq(&tmp, &liveout[i]) || fout != flagsout[i]) {
+               mask_copy(&liveout[i], &tmp);
+               flagsout[i] = fout;
+
+               mask_subtract(&tmp, &kill[i]);
+               mask_union(&tmp, &gen[i]);
+               mask_copy(&livein[i], &tmp);
+
+               if (!flagskill[i] && fout)
+                  flagsin[i] = true;
+
+               changed = true;
+            }
+         }
+      } while (changed);
+
+      for (int i = 0; i < cfg->nblocks; i++) {
+         jit_block_t *b = &(cfg->blocks[i]);
+         mask_copy(&live, &liveout[i]);
+         bool flags = flagsout[i];
+
+         for (int j = b->last; j >= (int)b->first; j--) {
+            if (mask_test(&o->dead, j))
+               continue;
+
+            jit_ir_t *ir = &(f->irbuf[j]);
+            const jit_reg_t def = optim_def(ir);
+
+            if (optim_is_pure(ir)
+                && (def == JIT_REG_INVALID || !mask_test(&live, def))
+                && (!optim_sets_flags(ir) || !flags)) {
+               mask_set(&o->dead, j);
+               o->changed = removed = true;
+               continue;
+            }
+
+            if (def != JIT_REG_INVALID)
+               mask_clear(&live, def);
+
+            if (optim_sets_flags(ir))
+               flags = false;
+            if (optim_reads_flags(ir))
+               flags = true;
+
+            jit_reg_t uses[3];
+            const int nuses = optim_uses(ir, uses);
+            for (int k = 0; k < nuses; k++)
+               mask_set(&live, uses[k]);
+         }
+      }
+   } while (removed);
+
+   for (int i = 0; i < cfg->nblocks; i++) {
+      mask_free(&livein[i]);
+      mask_free(&liveout[i]);
+      mask_free(&gen[i]);
+      mask_free(&kill[i]);
+   }
+
+   mask_free(&live);
+   mask_free(&tmp);
+
+   free(livein);
+   free(liveout);
+   free(gen);
+   free(kill);
+   free(flagsin);
+   free(flagsout);
+   free(flagskill);
+}
+
+void jit_optimise(jit_func_t *f)
+{
+   const bool verbose =
+      f->name != NULL && opt_get_verbose(OPT_JIT_VERBOSE, istr(f->name));
+
+   optim_run_pass(f, "propagate", optim_propagate, verbose);
+   optim_run_pass(f, "memory", optim_memory, verbose);
+   optim_run_pass(f, "propagate", optim_propagate, verbose);
+   optim_run_pass(f, "branches", optim_branches, verbose);
+   optim_run_pass(f, "dead code", optim_dead_code, verbose);
 }
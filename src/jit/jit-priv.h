@@ -186,12 +186,27 @@ STATIC_ASSERT(sizeof(jit_ir_t) == 40);
 typedef struct _jit_tier jit_tier_t;
 typedef struct _jit_func jit_func_t;
 typedef struct _jit_block jit_block_t;
+typedef struct _jit_insn jit_insn_t;
 
 typedef bool (*jit_entry_fn_t)(jit_func_t *, jit_scalar_t *);
 
+// Interpreter state passed to compiled code on loop entry
+typedef struct {
+   jit_scalar_t  *regs;
+   unsigned char *frame;
+   uint32_t       target;
+   uint32_t       flags;
+} jit_osr_state_t;
+
+typedef bool (*jit_osr_fn_t)(jit_func_t *, jit_scalar_t *, jit_osr_state_t *);
+
 typedef struct {
    unsigned count;
-   unsigned edges[4];
+   unsigned max;
+   union {
+      unsigned  edges[4];
+      unsigned *external;
+   };
 } jit_edge_list_t;
 
 typedef struct _jit_block {
@@ -227,10 +242,12 @@ typedef struct _jit_func {
    unsigned        cpoolsz;
    jit_handle_t    handle;
    void           *symbol;
-   unsigned        hotness;
+   int             hotness;
    jit_tier_t     *next_tier;
    jit_entry_fn_t  entry;
+   jit_osr_fn_t    osr_entry;
    jit_cfg_t      *cfg;
+   jit_insn_t     *threaded;
    ffi_spec_t      spec;
 } jit_func_t;
 
@@ -247,6 +264,7 @@ const char *jit_exit_name(jit_exit_t exit);
 bool jit_interp(jit_func_t *f, jit_scalar_t *args);
 void jit_interp_abort(int code);
 void jit_interp_trace(diag_t *d);
+void __nvc_do_exit(jit_exit_t which, jit_scalar_t *args);
 void jit_emit_trace(diag_t *d, const loc_t *loc, tree_t enclosing,
                     const char *symbol);
 jit_func_t *jit_get_func(jit_t *j, jit_handle_t handle);
@@ -256,6 +274,7 @@ void *jit_get_privdata(jit_t *j, jit_func_t *f);
 void jit_put_privdata(jit_t *j, jit_func_t *f, void *ptr);
 bool jit_has_runtime(jit_t *j);
 int jit_backedge_limit(jit_t *j);
+bool jit_has_threading(jit_t *j);
 void jit_tier_up(jit_func_t *f);
 jit_t *jit_for_thread(void);
 
@@ -263,5 +282,6 @@ jit_cfg_t *jit_get_cfg(jit_func_t *f);
 void jit_free_cfg(jit_func_t *f);
 jit_block_t *jit_block_for(jit_cfg_t *cfg, int pos);
 int jit_get_edge(jit_edge_list_t *list, int nth);
+void jit_optimise(jit_func_t *f);
 
 #endif  // _JIT_PRIV_H
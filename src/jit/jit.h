@@ -64,6 +64,7 @@ void jit_set_silent(jit_t *j, bool silent);
 const jit_layout_t *jit_layout(jit_t *j, type_t type);
 void jit_limit_backedges(jit_t *j, int limit);
 void jit_enable_runtime(jit_t *j, bool enable);
+void jit_enable_threading(jit_t *j, bool enable);
 mspace_t *jit_get_mspace(jit_t *j);
 void jit_load_dll(jit_t *j, ident_t name);
 int jit_exit_status(jit_t *j);
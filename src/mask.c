@@ -58,7 +58,9 @@ static inline uint64_t mask_for_range(int low, int high)
 
 void mask_clear_range(bit_mask_t *m, int start, int count)
 {
-   if (m->size <= 64) {
+   if (count == 0)
+      return;
+   else if (m->size <= 64) {
       m->bits &= ~mask_for_range(start, start + count - 1);
       return;
    }
@@ -90,7 +92,9 @@ void mask_clear_range(bit_mask_t *m, int start, int count)
 
 void mask_set_range(bit_mask_t *m, int start, int count)
 {
-   if (m->size <= 64) {
+   if (count == 0)
+      return;
+   else if (m->size <= 64) {
       m->bits |= mask_for_range(start, start + count - 1);
       return;
    }
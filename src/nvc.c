@@ -384,7 +384,7 @@ static int run(int argc, char **argv)
 {
    static struct option long_options[] = {
       { "trace",         no_argument,       0, 't' },
-      { "profile",       no_argument,       0, 'p' },
+      { "profile",       optional_argument, 0, 'p' },
       { "stop-time",     required_argument, 0, 's' },
       { "stats",         no_argument,       0, 'S' },
       { "wave",          optional_argument, 0, 'w' },
@@ -398,14 +398,22 @@ static int run(int argc, char **argv)
       { "load",          required_argument, 0, 'l' },
       { "vhpi-trace",    no_argument,       0, 'T' },
       { "gtkw",          optional_argument, 0, 'g' },
+      { "parallel",      no_argument,       0, 'P' },
+      { "levelise",      no_argument,       0, 'L' },
+      { "fork",          required_argument, 0, 'F' },
+      { "fork-at",       required_argument, 0, 'A' },
       { 0, 0, 0, 0 }
    };
 
    wave_format_t wave_fmt = WAVE_FORMAT_FST;
    uint64_t      stop_time = TIME_HIGH;
+   uint64_t      fork_time = 0;
+   int           fork_count = 0;
+   bool          fork_at = false;
    const char   *wave_fname = NULL;
    const char   *gtkw_fname = NULL;
    const char   *vhpi_plugins = NULL;
+   const char   *profile_fname = NULL;
 
    static bool have_run = false;
    if (have_run)
@@ -428,7 +436,7 @@ static int run(int argc, char **argv)
          opt_set_int(OPT_RT_TRACE, 1);
          break;
       case 'p':
-         opt_set_int(OPT_RT_PROFILE, 1);
+         profile_fname = optarg ?: "";
          break;
       case 'T':
          opt_set_str(OPT_VHPI_TRACE, "1");
@@ -447,6 +455,20 @@ static int run(int argc, char **argv)
       case 'S':
          opt_set_int(OPT_RT_STATS, 1);
          break;
+      case 'P':
+         opt_set_int(OPT_RT_PARALLEL, 1);
+         break;
+      case 'L':
+         opt_set_int(OPT_RT_LEVELISE, 1);
+         break;
+      case 'F':
+         if ((fork_count = parse_int(optarg)) <= 0)
+            fatal("invalid number of forks: %s", optarg);
+         break;
+      case 'A':
+         fork_time = parse_time(optarg);
+         fork_at = true;
+         break;
       case 'w':
          if (optarg == NULL)
             wave_fname = "";
@@ -487,6 +509,13 @@ static int run(int argc, char **argv)
 
    set_top_level(argv, next_cmd);
 
+   if (fork_count > 0 && wave_fname != NULL)
+      fatal("$bold$--fork$$ cannot be used with $bold$--wave$$");
+   else if (fork_count > 0 && opt_get_int(OPT_RT_PARALLEL))
+      fatal("$bold$--fork$$ cannot be used with $bold$--parallel$$");
+   else if (fork_at && fork_count == 0)
+      fatal("$bold$--fork-at$$ requires $bold$--fork$$");
+
    ident_t ename = ident_prefix(top_level, well_known(W_ELAB), '.');
    tree_t top = lib_get(lib_work(), ename);
    if (top == NULL)
@@ -515,6 +544,13 @@ static int run(int argc, char **argv)
    else if (gtkw_fname != NULL)
       warnf("$bold$--gtkw$$ option has no effect without $bold$--wave$$");
 
+   if (profile_fname != NULL && *profile_fname == '\0') {
+      char *tmp LOCAL = xasprintf("%s.profile.json", top_level_orig);
+      opt_set_str(OPT_RT_PROFILE, tmp);
+   }
+   else
+      opt_set_str(OPT_RT_PROFILE, profile_fname);
+
    if (opt_get_int(OPT_HEAP_SIZE) < 0x100000)
       warnf("recommended heap size is at least 1M");
 
@@ -528,6 +564,9 @@ static int run(int argc, char **argv)
 
    rt_model_t *model = model_new(top, jit);
 
+   if (fork_count > 0)
+      model_set_fork(model, fork_time, fork_count);
+
    if (vhpi_plugins != NULL)
       vhpi_load_plugins(top, model, vhpi_plugins);
 
@@ -874,7 +913,7 @@ static void set_default_opts(void)
    opt_set_str(OPT_DUMP_VCODE, getenv("NVC_LOWER_VERBOSE"));
    opt_set_int(OPT_IGNORE_TIME, 0);
    opt_set_int(OPT_VERBOSE, 0);
-   opt_set_int(OPT_RT_PROFILE, 0);
+   opt_set_str(OPT_RT_PROFILE, NULL);
    opt_set_int(OPT_SYNTHESIS, 0);
    opt_set_int(OPT_MISSING_BODY, 1);
    opt_set_int(OPT_ERROR_LIMIT, -1);
@@ -893,6 +932,9 @@ static void set_default_opts(void)
    opt_set_int(OPT_JIT_LOG, getenv("NVC_JIT_LOG") != NULL);
    opt_set_int(OPT_WARN_HIDDEN, 0);
    opt_set_int(OPT_NO_SAVE, 0);
+   opt_set_int(OPT_RT_PARALLEL, 0);
+   opt_set_int(OPT_RT_LEVELISE, 0);
+   opt_set_int(OPT_PERF_MAP, getenv("NVC_PERF_MAP") != NULL);
 }
 
 static void usage(void)
@@ -943,12 +985,19 @@ static void usage(void)
           "     --exclude=GLOB\tExclude signals matching GLOB from wave dump\n"
           "     --exit-severity=\tExit after assertion failure of "
           "this severity\n"
+          "     --fork=N\t\tContinue simulation in N child processes\n"
+          "     --fork-at=T\tFork child processes at simulation time T\n"
           "     --format=FMT\tWaveform format is either fst or vcd\n"
           "     --ieee-warnings=\tEnable ('on') or disable ('off') warnings\n"
           "     \t\t\tfrom IEEE packages\n"
           "     --include=GLOB\tInclude signals matching GLOB in wave dump\n"
+          "     --levelise\t\tRun combinational processes in dependency\n"
+          "     \t\t\torder without extra delta cycles\n"
           "     --load=PLUGIN\tLoad VHPI plugin at startup\n"
-          "     --profile\t\tDisplay detailed statistics at end of run\n"
+          "     --parallel\t\tRun processes concurrently on multiple "
+          "threads\n"
+          "     --profile[=FILE]\tReport busiest processes and signals at end\n"
+          "     \t\t\tof run and write profile data to FILE\n"
           "     --stats\t\tPrint time and memory usage at end of run\n"
           "     --stop-delta=N\tStop after N delta cycles (default %d)\n"
           "     --stop-time=T\tStop after simulation time T (e.g. 5ns)\n"
@@ -55,6 +55,9 @@ typedef enum {
    OPT_JIT_LOG,
    OPT_WARN_HIDDEN,
    OPT_NO_SAVE,
+   OPT_RT_PARALLEL,
+   OPT_RT_LEVELISE,
+   OPT_PERF_MAP,
 
    OPT_LAST_NAME
 } opt_name_t;
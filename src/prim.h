@@ -57,6 +57,7 @@ typedef struct _rt_proc       rt_proc_t;
 typedef struct _rt_alias      rt_alias_t;
 typedef struct _rt_implicit   rt_implicit_t;
 typedef struct _rt_resolution rt_resolution_t;
+typedef struct _rt_partition  rt_partition_t;
 
 typedef struct event     event_t;
 typedef struct waveform  waveform_t;
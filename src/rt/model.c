@@ -36,6 +36,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __x86_64__
+#include <tmmintrin.h>
+#endif
+
+#ifndef __MINGW32__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 typedef struct _callback callback_t;
 typedef struct _memblock memblock_t;
 
@@ -47,6 +56,7 @@ typedef struct _callback {
 
 #define MEMBLOCK_LINE_SZ 64
 #define MEMBLOCK_PAGE_SZ 0x200000
+#define NET_CHUNK_SZ     256
 
 typedef struct _memblock {
    memblock_t *chain;
@@ -55,6 +65,85 @@ typedef struct _memblock {
    char       *ptr;
 } memblock_t;
 
+typedef enum {
+   TX_WAVEFORM,
+   TX_WAVEFORM_S,
+   TX_EVENT,
+   TX_PROCESS,
+   TX_DISCONNECT,
+   TX_FORCE,
+   TX_RELEASE,
+} tx_kind_t;
+
+// Signal operations from processes running concurrently are recorded
+// in a per-thread buffer and replayed by the main thread once all the
+// processes in the cycle have finished
+typedef struct {
+   tx_kind_t      kind;
+   uint32_t       offset;
+   int32_t        count;
+   uint32_t       valuesz;
+   rt_proc_t     *proc;
+   rt_signal_t   *signal;
+   int64_t        after;
+   int64_t        reject;
+   rt_wakeable_t *wake;
+   bool           recur;
+   uint64_t       values[0];
+} tx_record_t;
+
+typedef struct {
+   char   *data;
+   size_t  used;
+   size_t  size;
+   tlab_t  tlab;
+} txbuf_t;
+
+typedef struct {
+   task_fn_t  fn;
+   void      *arg;
+} part_task_t;
+
+// Nexuses connected through port maps are grouped into a partition
+// whose driving and effective values can be updated independently of
+// every other partition
+typedef struct _rt_partition {
+   rt_partition_t  *parent;
+   A(part_task_t)   tasks;
+   A(rt_nexus_t *)  effq;
+   A(rt_net_t *)    events;
+   waveform_t      *freed;
+} rt_partition_t;
+
+typedef A(rt_partition_t *) partition_list_t;
+typedef A(rt_source_t *) source_list_t;
+
+#define PROFILE_BUCKETS 8
+
+typedef struct {
+   uint64_t timesteps;
+   uint64_t cycles;
+   unsigned max_cycles;
+   uint64_t max_cycles_time;
+   uint64_t buckets[PROFILE_BUCKETS];
+} profile_t;
+
+#define MAX_FUSE_TRIGGERS 16
+
+typedef struct _fuse_group fuse_group_t;
+
+typedef struct {
+   tree_t      decl;
+   rt_scope_t *scope;
+} fuse_trigger_t;
+
+typedef struct _fuse_group {
+   fuse_group_t   *next;
+   rt_proc_t      *tail;
+   int             ntriggers;
+   fuse_trigger_t  triggers[0];
+} fuse_group_t;
+
 typedef struct _rt_model {
    tree_t             top;
    hash_t            *scopes;
@@ -70,7 +159,7 @@ typedef struct _rt_model {
    bool               next_is_delta;
    bool               force_stop;
    unsigned           n_signals;
-   heap_t            *eventq_heap;
+   wheel_t           *eventq;
    ihash_t           *res_memo;
    rt_alloc_stack_t   event_stack;
    rt_alloc_stack_t   sens_list_stack;
@@ -88,9 +177,28 @@ typedef struct _rt_model {
    cover_tagging_t   *cover;
    nvc_rusage_t       ready_rusage;
    memblock_t        *memblocks;
+   bool               parallel;
+   workq_t           *watchq;
+   txbuf_t           *txbufs[MAX_THREADS];
+   workq_t           *partq;
+   partition_list_t   partitions;
+   partition_list_t   active_parts;
+   rt_net_t          *netchunk;
+   unsigned           netfree;
+   uint32_t           next_net_id;
+   bool               nets_packed;
+   unsigned           fork_count;
+   uint64_t           fork_time;
+   int                fork_index;
+   const char        *profile;
+   profile_t          prof;
+   heap_t            *levelq;
+   bool               levelising;
+   source_list_t      immediate;
 } rt_model_t;
 
 #define FMT_VALUES_SZ   128
+#define EVENTQ_SHIFT    20   // Approximately 1 ns per timing wheel slot
 #define NEXUS_INDEX_MIN 8
 #define TRACE_SIGNALS   1
 
@@ -116,28 +224,44 @@ typedef struct _rt_model {
    rt_model_t *__save __attribute__((unused, cleanup(__model_exit)));   \
    __model_entry(m, &__save);                                           \
 
-static __thread rt_proc_t    *active_proc = NULL;
-static __thread rt_scope_t   *active_scope = NULL;
-static __thread rt_signal_t **signals_tail = NULL;
-static __thread rt_scope_t  **scopes_tail = NULL;
-static __thread rt_model_t   *__model = NULL;
-static __thread tlab_t        spare_tlab = {};
-static __thread waveform_t   *free_waveforms = NULL;
+static __thread rt_proc_t      *active_proc = NULL;
+static __thread rt_scope_t     *active_scope = NULL;
+static __thread rt_signal_t   **signals_tail = NULL;
+static __thread rt_scope_t    **scopes_tail = NULL;
+static __thread rt_model_t     *__model = NULL;
+static __thread tlab_t          spare_tlab = {};
+static __thread waveform_t     *free_waveforms = NULL;
+static __thread txbuf_t        *active_txbuf = NULL;
+static __thread rt_partition_t *active_partition = NULL;
 
+static bool have_ssse3 = false;
+
+#ifdef __MINGW32__
 DLLEXPORT tlab_t __nvc_tlab = {};   // TODO: this should be thread-local
+#else
+DLLEXPORT __thread tlab_t __nvc_tlab = {};
+#endif
 
 static bool __trace_on = false;
 
 static void *driving_value(rt_nexus_t *nexus);
+static void propagate_nexus(rt_nexus_t *nexus, const void *resolved);
 static void *source_value(rt_nexus_t *nexus, rt_source_t *src);
 static void free_value(rt_nexus_t *n, rt_value_t v);
+static void index_free(rt_index_t *index);
+static rt_source_t *find_driver(rt_nexus_t *nexus);
+static void sched_waveform_s(rt_model_t *m, rt_signal_t *s, uint32_t offset,
+                             uint64_t scalar, int64_t after, int64_t reject);
 static rt_nexus_t *clone_nexus(rt_model_t *m, rt_nexus_t *old, int offset,
                                rt_net_t *net);
 static void update_implicit_signal(rt_model_t *m, rt_implicit_t *imp);
+static void update_driver(rt_model_t *m, rt_nexus_t *nexus,
+                          rt_source_t *source);
 static void async_run_process(void *context, void *arg);
 static void async_update_driver(void *context, void *arg);
 static void async_update_driving(void *context, void *arg);
 static void async_disconnect(void *context, void *arg);
+static void async_update_partition(void *context, void *arg);
 
 static int fmt_now(rt_model_t *m, char *buf, size_t len)
 {
@@ -306,6 +430,431 @@ static void scope_deps_cb(ident_t unit_name, void *__ctx)
    scopes_tail = &(s->chain);
 }
 
+typedef struct {
+   hset_t *locals;
+   bool    exclusive;
+} exclusive_ctx_t;
+
+static void local_subprograms_cb(tree_t t, void *ctx)
+{
+   exclusive_ctx_t *ec = ctx;
+
+   if (is_subprogram(t))
+      hset_insert(ec->locals, t);
+}
+
+static void exclusive_process_cb(tree_t t, void *ctx)
+{
+   exclusive_ctx_t *ec = ctx;
+
+   switch (tree_kind(t)) {
+   case T_PROT_FCALL:
+   case T_PROT_PCALL:
+   case T_PROT_REF:
+      break;
+
+   case T_REF:
+      if (tree_has_ref(t)) {
+         tree_t decl = tree_ref(t);
+         switch (tree_kind(decl)) {
+         case T_FILE_DECL:
+            break;
+         case T_VAR_DECL:
+            if (tree_flags(decl) & TREE_F_SHARED)
+               break;
+            return;
+         default:
+            return;
+         }
+      }
+      else
+         return;
+      break;
+
+   case T_FCALL:
+   case T_PCALL:
+      {
+         tree_t decl = tree_ref(t);
+         if (hset_contains(ec->locals, decl))
+            return;
+         else if (!is_subprogram(decl) || tree_kind(decl) == T_GENERIC_DECL)
+            break;
+
+         switch (tree_subkind(decl)) {
+         case S_USER:
+            {
+               // Pure functions cannot access anything outside the
+               // process other than their arguments
+               const tree_flags_t mask = TREE_F_IMPURE | TREE_F_FOREIGN;
+               if (tree_kind(t) == T_PCALL || (tree_flags(decl) & mask))
+                  break;
+            }
+            return;
+         case S_FOREIGN:
+         case S_VHPIDIRECT:
+         case S_FILE_OPEN1:
+         case S_FILE_OPEN2:
+         case S_FILE_CLOSE:
+         case S_FILE_READ:
+         case S_FILE_WRITE:
+         case S_FILE_FLUSH:
+         case S_ENDFILE:
+            break;
+         default:
+            return;
+         }
+      }
+      break;
+
+   default:
+      return;
+   }
+
+   // Must not run concurrently with any other process
+   ec->exclusive = true;
+}
+
+static bool is_exclusive_process(tree_t proc)
+{
+   exclusive_ctx_t ec = {
+      .locals    = hset_new(16),
+      .exclusive = false,
+   };
+
+   tree_visit(proc, local_subprograms_cb, &ec);
+   tree_visit(proc, exclusive_process_cb, &ec);
+
+   hset_free(ec.locals);
+   return ec.exclusive;
+}
+
+#define SILENT_CALL_DEPTH 4   // Calls followed for conversion functions
+
+static bool is_silent_subprogram(tree_t decl, int depth);
+
+typedef struct {
+   int  depth;
+   bool silent;
+} silent_ctx_t;
+
+static void silent_subprogram_cb(tree_t t, void *context)
+{
+   silent_ctx_t *ctx = context;
+
+   switch (tree_kind(t)) {
+   case T_ASSERT:
+      ctx->silent = false;   // Also report statements
+      break;
+
+   case T_FCALL:
+   case T_PCALL:
+      if (!tree_has_ref(t) || !is_silent_subprogram(tree_ref(t), ctx->depth))
+         ctx->silent = false;
+      break;
+
+   case T_PROT_FCALL:
+   case T_PROT_PCALL:
+      ctx->silent = false;
+      break;
+
+   default:
+      break;
+   }
+}
+
+static tree_t subprogram_body(tree_t decl)
+{
+   const tree_kind_t kind = tree_kind(decl);
+   if (kind == T_FUNC_BODY || kind == T_PROC_BODY)
+      return decl;
+   else if (!tree_has_ident2(decl))
+      return NULL;
+
+   // The body of a subprogram declared in a package is in the package
+   // body named by the first two components of its mangled name
+   const char *symbol = istr(tree_ident2(decl)), *dot = strchr(symbol, '.');
+   if (dot == NULL || (dot = strchr(dot + 1, '.')) == NULL)
+      return NULL;
+
+   char *unit LOCAL = xstrdup(symbol);
+   unit[dot - symbol] = '\0';
+
+   tree_t body = find_enclosing_decl(ident_new(unit), symbol);
+   if (body == NULL)
+      return NULL;
+
+   const tree_kind_t bkind = tree_kind(body);
+   if (bkind != T_FUNC_BODY && bkind != T_PROC_BODY)
+      return NULL;
+
+   return body;
+}
+
+static bool is_silent_subprogram(tree_t decl, int depth)
+{
+   // True if calling the subprogram can have no visible effect other
+   // than its return value so calls to it may be skipped or reordered:
+   // it must be pure and must not contain any report or assertion,
+   // including in subprograms it calls up to the given depth
+
+   if (!is_subprogram(decl) || tree_kind(decl) == T_GENERIC_DECL)
+      return false;
+
+   switch (tree_subkind(decl)) {
+   case S_USER:
+      break;
+   case S_FOREIGN:
+   case S_VHPIDIRECT:
+   case S_FILE_OPEN1:
+   case S_FILE_OPEN2:
+   case S_FILE_CLOSE:
+   case S_FILE_READ:
+   case S_FILE_WRITE:
+   case S_FILE_FLUSH:
+   case S_ENDFILE:
+   case S_DEALLOCATE:
+      return false;
+   default:
+      return true;   // Predefined operation
+   }
+
+   if (depth <= 0)
+      return false;
+   else if (tree_flags(decl) & (TREE_F_IMPURE | TREE_F_FOREIGN))
+      return false;
+
+   tree_t body = subprogram_body(decl);
+   if (body == NULL)
+      return false;
+
+   silent_ctx_t ctx = {
+      .depth  = depth - 1,
+      .silent = true,
+   };
+   tree_visit(body, silent_subprogram_cb, &ctx);
+
+   return ctx.silent;
+}
+
+static rt_clock_t *clock_for_process(tree_t proc)
+{
+   // Recognise free-running clock generators such as "clk <= not clk
+   // after 5 ns" which can be serviced by the scheduler without
+   // resuming the process once the next value for each value of the
+   // signal is known
+
+   if (tree_stmts(proc) != 2 || tree_decls(proc) != 0)
+      return NULL;
+   else if (tree_flags(proc) & TREE_F_POSTPONED)
+      return NULL;
+
+   tree_t assign = tree_stmt(proc, 0), wait = tree_stmt(proc, 1);
+   if (tree_kind(assign) != T_SIGNAL_ASSIGN || tree_kind(wait) != T_WAIT)
+      return NULL;
+   else if (!(tree_flags(wait) & TREE_F_STATIC_WAIT))
+      return NULL;
+   else if (tree_has_value(wait) || tree_has_delay(wait))
+      return NULL;
+   else if (tree_triggers(wait) != 1 || tree_waveforms(assign) != 1)
+      return NULL;
+
+   tree_t target = tree_target(assign);
+   if (tree_kind(target) != T_REF)
+      return NULL;
+
+   tree_t decl = tree_ref(target);
+   if (tree_kind(decl) != T_SIGNAL_DECL)
+      return NULL;
+
+   tree_t trigger = tree_trigger(wait, 0);
+   if (tree_kind(trigger) != T_REF || tree_ref(trigger) != decl)
+      return NULL;
+
+   tree_t w = tree_waveform(assign, 0);
+   if (!tree_has_value(w) || !tree_has_delay(w))
+      return NULL;
+
+   int64_t after, reject = 0;
+   if (!folded_int(tree_delay(w), &after) || after <= 0)
+      return NULL;
+   else if (tree_has_reject(assign)
+            && !folded_int(tree_reject(assign), &reject))
+      return NULL;
+
+   // The process is not resumed once the next value is known so the
+   // function must not report or call anything other than predefined
+   // operations
+   tree_t value = tree_value(w);
+   if (tree_kind(value) != T_FCALL || tree_params(value) != 1)
+      return NULL;
+   else if (!is_silent_subprogram(tree_ref(value), 1))
+      return NULL;
+
+   tree_t arg = tree_value(tree_param(value, 0));
+   if (tree_kind(arg) != T_REF || tree_ref(arg) != decl)
+      return NULL;
+
+   type_t type = tree_type(decl);
+   if (!type_is_enum(type))
+      return NULL;
+
+   const int nlits = type_enum_literals(type_base_recur(type));
+   if (nlits > 256)
+      return NULL;
+
+   rt_clock_t *c = xmalloc_flex(sizeof(rt_clock_t), nlits, sizeof(int16_t));
+   c->decl   = decl;
+   c->signal = NULL;
+   c->after  = after;
+   c->reject = reject;
+   c->nlits  = nlits;
+
+   for (int i = 0; i < nlits; i++)
+      c->next[i] = -1;   // Not yet known
+
+   return c;
+}
+
+typedef struct {
+   hash_t *groups;
+   hash_t *decls;
+} fuse_ctx_t;
+
+static int trigger_cmp(const void *a, const void *b)
+{
+   const fuse_trigger_t *ta = a, *tb = b;
+   if (ta->decl != tb->decl)
+      return (uintptr_t)ta->decl < (uintptr_t)tb->decl ? -1 : 1;
+   else if (ta->scope != tb->scope)
+      return (uintptr_t)ta->scope < (uintptr_t)tb->scope ? -1 : 1;
+   else
+      return 0;
+}
+
+static rt_scope_t *trigger_scope(fuse_ctx_t *ctx, rt_scope_t *s, tree_t decl)
+{
+   // The same declaration may be shared between several instances of
+   // a block so find the nearest enclosing scope which declares it
+   for (; s != NULL && s->kind == SCOPE_INSTANCE; s = s->parent) {
+      hset_t *decls = hash_get(ctx->decls, s);
+      if (decls == NULL) {
+         decls = hset_new(32);
+
+         const int nports = tree_ports(s->where);
+         for (int i = 0; i < nports; i++)
+            hset_insert(decls, tree_port(s->where, i));
+
+         const int ndecls = tree_decls(s->where);
+         for (int i = 0; i < ndecls; i++)
+            hset_insert(decls, tree_decl(s->where, i));
+
+         hash_put(ctx->decls, s, decls);
+      }
+
+      if (hset_contains(decls, decl))
+         return s;
+   }
+
+   return NULL;
+}
+
+static void fuse_process(fuse_ctx_t *ctx, rt_proc_t *p)
+{
+   // Processes whose only wait is a static wait on the same set of
+   // signals are always resumed together and so can be scheduled as a
+   // single unit which runs each member in turn with its own drivers
+
+   if (p->wakeable.postponed || p->clock != NULL)
+      return;
+
+   const int nstmts = tree_stmts(p->where);
+   if (nstmts == 0)
+      return;
+
+   tree_t wait = tree_stmt(p->where, nstmts - 1);
+   if (tree_kind(wait) != T_WAIT || !(tree_flags(wait) & TREE_F_STATIC_WAIT))
+      return;
+
+   const int ntriggers = tree_triggers(wait);
+   if (ntriggers == 0 || ntriggers > MAX_FUSE_TRIGGERS)
+      return;
+
+   fuse_trigger_t triggers[MAX_FUSE_TRIGGERS];
+   for (int i = 0; i < ntriggers; i++) {
+      tree_t t = tree_trigger(wait, i);
+      if (tree_kind(t) != T_REF)
+         return;
+
+      triggers[i].decl  = tree_ref(t);
+      triggers[i].scope = trigger_scope(ctx, p->scope, triggers[i].decl);
+
+      if (triggers[i].scope == NULL)
+         return;
+   }
+
+   qsort(triggers, ntriggers, sizeof(fuse_trigger_t), trigger_cmp);
+
+   const size_t cmpsz = ntriggers * sizeof(fuse_trigger_t);
+
+   fuse_group_t *head = hash_get(ctx->groups, triggers[0].scope), *g = head;
+   for (; g != NULL; g = g->next) {
+      if (g->ntriggers == ntriggers && memcmp(g->triggers, triggers, cmpsz) == 0)
+         break;
+   }
+
+   if (g == NULL) {
+      g = xmalloc_flex(sizeof(fuse_group_t), ntriggers,
+                       sizeof(fuse_trigger_t));
+      g->next      = head;
+      g->tail      = p;
+      g->ntriggers = ntriggers;
+      memcpy(g->triggers, triggers, cmpsz);
+
+      hash_put(ctx->groups, triggers[0].scope, g);
+   }
+   else {
+      p->follower = true;
+      g->tail->fused = p;
+      g->tail = p;
+   }
+}
+
+static void fuse_scope(fuse_ctx_t *ctx, rt_scope_t *s)
+{
+   for (rt_proc_t *p = s->procs; p != NULL; p = p->chain)
+      fuse_process(ctx, p);
+
+   for (rt_scope_t *c = s->child; c != NULL; c = c->chain)
+      fuse_scope(ctx, c);
+}
+
+static void fuse_processes(rt_model_t *m)
+{
+   fuse_ctx_t ctx = {
+      .groups = hash_new(256),
+      .decls  = hash_new(256),
+   };
+
+   fuse_scope(&ctx, m->root);
+
+   const void *key;
+   void *value;
+   for (hash_iter_t it = HASH_BEGIN;
+        hash_iter(ctx.groups, &it, &key, &value); ) {
+      for (fuse_group_t *g = value, *tmp; g; g = tmp) {
+         tmp = g->next;
+         free(g);
+      }
+   }
+
+   for (hash_iter_t it = HASH_BEGIN;
+        hash_iter(ctx.decls, &it, &key, &value); )
+      hset_free(value);
+
+   hash_free(ctx.groups);
+   hash_free(ctx.decls);
+}
+
 static rt_scope_t *scope_for_block(rt_model_t *m, tree_t block, ident_t prefix)
 {
    rt_scope_t *s = xcalloc(sizeof(rt_scope_t));
@@ -372,6 +921,11 @@ static rt_scope_t *scope_for_block(rt_model_t *m, tree_t block, ident_t prefix)
             p->wakeable.pending    = false;
             p->wakeable.postponed  = !!(tree_flags(t) & TREE_F_POSTPONED);
 
+            if (m->parallel)
+               p->exclusive = is_exclusive_process(t);
+
+            p->clock = clock_for_process(t);
+
             *procp = p;
             procp = &(p->chain);
          }
@@ -395,11 +949,22 @@ rt_model_t *model_new(tree_t top, jit_t *jit)
    m->nexus_tail  = &(m->nexuses);
    m->iteration   = -1;
    m->stop_delta  = opt_get_int(OPT_STOP_DELTA);
-   m->eventq_heap = heap_new(512);
+   m->eventq      = wheel_new(EVENTQ_SHIFT);
    m->res_memo    = ihash_new(128);
+   m->next_net_id = 1;
+   m->fork_index  = -1;
+   m->profile     = opt_get_str(OPT_RT_PROFILE);
 
    m->can_create_delta = true;
 
+#ifndef __MINGW32__
+   m->parallel = opt_get_int(OPT_RT_PARALLEL);
+#endif
+
+#ifdef __x86_64__
+   have_ssse3 = __builtin_cpu_supports("ssse3");
+#endif
+
    m->event_stack     = rt_alloc_stack_new(sizeof(event_t), "event");
    m->sens_list_stack = rt_alloc_stack_new(sizeof(sens_list_t), "sens_list");
    m->watch_stack     = rt_alloc_stack_new(sizeof(rt_watch_t), "watch");
@@ -417,11 +982,31 @@ rt_model_t *model_new(tree_t top, jit_t *jit)
    m->delta_driverq = workq_new(m);
    m->effq          = workq_new(m);
 
+   if (m->parallel) {
+      // Only processes may execute concurrently
+      workq_not_thread_safe(m->postponedq);
+      workq_not_thread_safe(m->driverq);
+      workq_not_thread_safe(m->delta_driverq);
+      workq_not_thread_safe(m->effq);
+
+      m->watchq = workq_new(m);
+      workq_not_thread_safe(m->watchq);
+
+      m->partq = workq_new(m);
+   }
+
    scopes_tail = &(m->root->child);
    tree_walk_deps(top, scope_deps_cb, m);
 
    *scopes_tail = scope_for_block(m, tree_stmt(top, 0), lib_name(lib_work()));
 
+   // Running processes as a single unit defeats parallel execution
+   if (!m->parallel)
+      fuse_processes(m);
+
+   if (opt_get_int(OPT_RT_LEVELISE) && !m->parallel)
+      m->levelq = heap_new(128);
+
    __trace_on = opt_get_int(OPT_RT_TRACE);
 
    nvc_rusage(&m->ready_rusage);
@@ -467,10 +1052,12 @@ static void cleanup_nexus(rt_model_t *m, rt_nexus_t *n)
 
       switch (s->tag) {
       case SOURCE_DRIVER:
-         for (waveform_t *it = s->u.driver.waveforms.next, *next;
-              it; it = next) {
-            next = it->next;
-            free_waveform(it);
+         if (s->pending) {
+            for (waveform_t *it = s->u.driver.pending.next, *next;
+                 it; it = next) {
+               next = it->next;
+               free_waveform(it);
+            }
          }
          break;
 
@@ -496,7 +1083,7 @@ static void cleanup_signal(rt_model_t *m, rt_signal_t *s)
       cleanup_nexus(m, n);
    }
 
-   free(s->index);
+   index_free(s->index);
 
    if (s->flags & NET_F_IMPLICIT) {
       rt_implicit_t *imp = container_of(s, rt_implicit_t, signal);
@@ -512,6 +1099,9 @@ static void cleanup_scope(rt_model_t *m, rt_scope_t *scope)
       tmp = it->chain;
       mptr_free(m->mspace, &(it->privdata));
       tlab_release(&(it->tlab));
+      if (it->drivers != NULL)
+         ihash_free(it->drivers);
+      free(it->clock);
       free(it);
    }
 
@@ -534,64 +1124,339 @@ static void cleanup_scope(rt_model_t *m, rt_scope_t *scope)
    free(scope);
 }
 
-void model_free(rt_model_t *m)
-{
-   if (opt_get_int(OPT_RT_STATS)) {
-      nvc_rusage_t ru;
-      nvc_rusage(&ru);
+typedef A(rt_signal_t *) signal_list_t;
 
-      unsigned mem = 0;
-      for (memblock_t *mb = m->memblocks; mb; mb = mb->chain)
-         mem += mb->pagesz - (MEMBLOCK_LINE_SZ * mb->free);
+static ident_t signal_name(rt_signal_t *s)
+{
+   return ident_prefix(s->parent->name, tree_ident(s->where), '.');
+}
 
-      notef("setup:%ums run:%ums maxrss:%ukB static:%ukB",
-            m->ready_rusage.ms, ru.ms, ru.rss, mem / 1024);
+static void collect_split_signals(rt_scope_t *scope, signal_list_t *list)
+{
+   for (rt_signal_t *s = scope->signals; s != NULL; s = s->chain) {
+      if (s->n_nexus > 1)
+         APUSH(*list, s);
    }
 
-   while (heap_size(m->eventq_heap) > 0)
-      rt_free(m->event_stack, heap_extract_min(m->eventq_heap));
-
-   tlab_release(&__nvc_tlab);
+   for (rt_scope_t *c = scope->child; c != NULL; c = c->chain)
+      collect_split_signals(c, list);
+}
 
-   cleanup_scope(m, m->root);
+static int split_signal_cmp(const void *a, const void *b)
+{
+   const rt_signal_t *sa = *(const rt_signal_t **)a;
+   const rt_signal_t *sb = *(const rt_signal_t **)b;
 
-   workq_free(m->procq);
-   workq_free(m->delta_procq);
-   workq_free(m->postponedq);
-   workq_free(m->driverq);
-   workq_free(m->delta_driverq);
-   workq_free(m->effq);
+   if (sa->n_nexus != sb->n_nexus)
+      return sa->n_nexus > sb->n_nexus ? -1 : 1;
+   else
+      return 0;
+}
 
-   if (m->implicitq != NULL)
-      workq_free(m->implicitq);
+static void split_report(rt_model_t *m)
+{
+   // Report which signals were split into the most nexuses by partial
+   // drivers or port maps as these are expensive to update
+   signal_list_t list = AINIT;
+   collect_split_signals(m->root, &list);
 
-   for (rt_watch_t *it = m->watches, *tmp; it; it = tmp) {
-      tmp = it->chain_all;
-      rt_free(m->watch_stack, it);
-   }
+   qsort(list.items, list.count, sizeof(rt_signal_t *), split_signal_cmp);
 
-   for (int i = 0; i < RT_LAST_EVENT; i++) {
-      for (callback_t *it = m->global_cbs[i], *tmp; it; it = tmp) {
-         tmp = it->next;
-         rt_free(m->callback_stack, it);
-      }
-   }
+   unsigned total = 0;
+   for (int i = 0; i < list.count; i++)
+      total += list.items[i]->n_nexus;
 
-   rt_alloc_stack_destroy(m->event_stack);
-   rt_alloc_stack_destroy(m->sens_list_stack);
-   rt_alloc_stack_destroy(m->watch_stack);
-   rt_alloc_stack_destroy(m->callback_stack);
+   if (list.count > 0)
+      notef("%d signals split into %u nexuses", list.count, total);
 
-   for (memblock_t *mb = m->memblocks, *tmp; mb; mb = tmp) {
-      tmp = mb->chain;
-      nvc_munmap(mb->ptr, MEMBLOCK_PAGE_SZ);
-      free(mb);
+   const int max = MIN(list.count, 10);
+   for (int i = 0; i < max; i++) {
+      rt_signal_t *s = list.items[i];
+      notef("signal %s split into %u nexuses", istr(signal_name(s)),
+            s->n_nexus);
    }
 
-   heap_free(m->eventq_heap);
-   hash_free(m->scopes);
-   ihash_free(m->res_memo);
-   free(m);
+   ACLEAR(list);
+}
+
+typedef A(rt_proc_t *) proc_list_t;
+
+static void profile_time_step(rt_model_t *m)
+{
+   // Called at the end of each time step to record how many simulation
+   // cycles it took to settle
+   const unsigned cycles = m->iteration + 1;
+
+   m->prof.timesteps++;
+   m->prof.cycles += cycles;
+
+   if (cycles > m->prof.max_cycles) {
+      m->prof.max_cycles = cycles;
+      m->prof.max_cycles_time = m->now;
+   }
+
+   const int bucket = cycles == 1 ? 0 : MIN(ilog2(cycles), PROFILE_BUCKETS - 1);
+   m->prof.buckets[bucket]++;
+}
+
+static void collect_profile(rt_scope_t *scope, proc_list_t *procs,
+                            signal_list_t *signals)
+{
+   for (rt_proc_t *p = scope->procs; p != NULL; p = p->chain)
+      APUSH(*procs, p);
+
+   for (rt_signal_t *s = scope->signals; s != NULL; s = s->chain)
+      APUSH(*signals, s);
+
+   for (rt_scope_t *c = scope->child; c != NULL; c = c->chain)
+      collect_profile(c, procs, signals);
+}
+
+static int profile_proc_cmp(const void *a, const void *b)
+{
+   const rt_proc_t *pa = *(const rt_proc_t **)a;
+   const rt_proc_t *pb = *(const rt_proc_t **)b;
+
+   if (pa->prof_ns != pb->prof_ns)
+      return pa->prof_ns > pb->prof_ns ? -1 : 1;
+   else if (pa->prof_runs != pb->prof_runs)
+      return pa->prof_runs > pb->prof_runs ? -1 : 1;
+   else
+      return 0;
+}
+
+static int profile_signal_cmp(const void *a, const void *b)
+{
+   const rt_signal_t *sa = *(const rt_signal_t **)a;
+   const rt_signal_t *sb = *(const rt_signal_t **)b;
+
+   if (sa->prof_events != sb->prof_events)
+      return sa->prof_events > sb->prof_events ? -1 : 1;
+   else if (sa->prof_transactions != sb->prof_transactions)
+      return sa->prof_transactions > sb->prof_transactions ? -1 : 1;
+   else
+      return 0;
+}
+
+static void json_string(FILE *f, const char *str)
+{
+   fputc('"', f);
+   for (const unsigned char *p = (const unsigned char *)str; *p; p++) {
+      if (*p == '"' || *p == '\\')
+         fprintf(f, "\\%c", *p);
+      else if (*p < 0x20 || *p >= 0x80)
+         fprintf(f, "\\u%04x", *p);
+      else
+         fputc(*p, f);
+   }
+   fputc('"', f);
+}
+
+static void profile_write_json(rt_model_t *m, const char *fname,
+                               proc_list_t *procs, signal_list_t *signals)
+{
+   FILE *f = fopen(fname, "w");
+   if (f == NULL)
+      fatal_errno("%s", fname);
+
+   fprintf(f, "{\n  \"timesteps\": %"PRIu64",\n", m->prof.timesteps);
+   fprintf(f, "  \"cycles\": %"PRIu64",\n", m->prof.cycles);
+   fprintf(f, "  \"max_cycles\": %u,\n", m->prof.max_cycles);
+   fprintf(f, "  \"max_cycles_time\": %"PRIu64",\n",
+           m->prof.max_cycles_time);
+
+   fprintf(f, "  \"cycles_histogram\": [");
+   for (int i = 0; i < PROFILE_BUCKETS; i++)
+      fprintf(f, "%s%"PRIu64, i > 0 ? ", " : "", m->prof.buckets[i]);
+   fprintf(f, "],\n");
+
+   fprintf(f, "  \"processes\": [");
+   for (int i = 0; i < procs->count; i++) {
+      rt_proc_t *p = procs->items[i];
+      fprintf(f, "%s\n    {\"name\": ", i > 0 ? "," : "");
+      json_string(f, istr(p->name));
+      fprintf(f, ", \"runs\": %"PRIu64", \"cpu_ns\": %"PRIu64"}",
+              p->prof_runs, p->prof_ns);
+   }
+   fprintf(f, "\n  ],\n");
+
+   fprintf(f, "  \"signals\": [");
+   for (int i = 0; i < signals->count; i++) {
+      rt_signal_t *s = signals->items[i];
+      fprintf(f, "%s\n    {\"name\": ", i > 0 ? "," : "");
+      json_string(f, istr(signal_name(s)));
+      fprintf(f, ", \"events\": %"PRIu64", \"transactions\": %"PRIu64"}",
+              s->prof_events, s->prof_transactions);
+   }
+   fprintf(f, "\n  ]\n}\n");
+
+   fclose(f);
+}
+
+static void profile_report(rt_model_t *m)
+{
+   profile_time_step(m);   // Final time step
+
+   proc_list_t procs = AINIT;
+   signal_list_t signals = AINIT;
+   collect_profile(m->root, &procs, &signals);
+
+   qsort(procs.items, procs.count, sizeof(rt_proc_t *), profile_proc_cmp);
+   qsort(signals.items, signals.count, sizeof(rt_signal_t *),
+         profile_signal_cmp);
+
+   uint64_t total_ns = 0;
+   for (int i = 0; i < procs.count; i++)
+      total_ns += procs.items[i]->prof_ns;
+
+   printf("\n%-20s %"PRIu64"\n", "Time steps", m->prof.timesteps);
+   printf("%-20s %"PRIu64"\n", "Simulation cycles", m->prof.cycles);
+   printf("%-20s %u at %s\n", "Most cycles", m->prof.max_cycles,
+          fmt_time(m->prof.max_cycles_time));
+
+   static const char *labels[PROFILE_BUCKETS] = {
+      "1", "2", "3-4", "5-8", "9-16", "17-32", "33-64", ">64"
+   };
+
+   printf("\n%-20s %12s\n", "Cycles per step", "Time steps");
+   for (int i = 0; i < PROFILE_BUCKETS; i++)
+      printf("%-20s %12"PRIu64"\n", labels[i], m->prof.buckets[i]);
+
+   printf("\n%-40s %10s %12s %6s\n", "Process", "Runs", "CPU (us)", "%");
+   for (int i = 0; i < MIN(procs.count, 10); i++) {
+      rt_proc_t *p = procs.items[i];
+      if (p->prof_runs == 0)
+         break;
+
+      printf("%-40s %10"PRIu64" %12.1f %6.1f\n", istr(p->name),
+             p->prof_runs, p->prof_ns / 1000.0,
+             total_ns ? 100.0 * p->prof_ns / total_ns : 0.0);
+   }
+
+   printf("\n%-40s %10s %12s\n", "Signal", "Events", "Transactions");
+   for (int i = 0; i < MIN(signals.count, 10); i++) {
+      rt_signal_t *s = signals.items[i];
+      if (s->prof_events == 0 && s->prof_transactions == 0)
+         break;
+
+      printf("%-40s %10"PRIu64" %12"PRIu64"\n", istr(signal_name(s)),
+             s->prof_events, s->prof_transactions);
+   }
+
+   printf("\n");
+   fflush(stdout);
+
+   // Each forked child writes a separate file so they do not overwrite
+   // each other or the parent
+   char *tmp LOCAL = NULL;
+   const char *fname = m->profile;
+   if (m->fork_index >= 0)
+      fname = tmp = xasprintf("%s.%d", m->profile, m->fork_index);
+
+   profile_write_json(m, fname, &procs, &signals);
+   notef("wrote profile data to %s", fname);
+
+   ACLEAR(procs);
+   ACLEAR(signals);
+}
+
+void model_free(rt_model_t *m)
+{
+   if (opt_get_int(OPT_RT_STATS)) {
+      nvc_rusage_t ru;
+      nvc_rusage(&ru);
+
+      unsigned mem = 0;
+      for (memblock_t *mb = m->memblocks; mb; mb = mb->chain)
+         mem += mb->pagesz - (MEMBLOCK_LINE_SZ * mb->free);
+
+      notef("setup:%ums run:%ums maxrss:%ukB static:%ukB",
+            m->ready_rusage.ms, ru.ms, ru.rss, mem / 1024);
+
+      split_report(m);
+   }
+
+   if (m->profile != NULL)
+      profile_report(m);
+
+   uint64_t when;
+   void **batch;
+   size_t nbatch;
+   while ((nbatch = wheel_pop(m->eventq, &when, &batch)) > 0) {
+      for (size_t i = 0; i < nbatch; i++)
+         rt_free(m->event_stack, batch[i]);
+   }
+
+   tlab_release(&__nvc_tlab);
+
+   cleanup_scope(m, m->root);
+
+   if (m->levelq != NULL)
+      heap_free(m->levelq);
+
+   ACLEAR(m->immediate);
+
+   workq_free(m->procq);
+   workq_free(m->delta_procq);
+   workq_free(m->postponedq);
+   workq_free(m->driverq);
+   workq_free(m->delta_driverq);
+   workq_free(m->effq);
+
+   if (m->implicitq != NULL)
+      workq_free(m->implicitq);
+
+   if (m->watchq != NULL)
+      workq_free(m->watchq);
+
+   if (m->partq != NULL)
+      workq_free(m->partq);
+
+   for (int i = 0; i < m->partitions.count; i++) {
+      rt_partition_t *p = m->partitions.items[i];
+      ACLEAR(p->tasks);
+      ACLEAR(p->effq);
+      ACLEAR(p->events);
+      free(p);
+   }
+   ACLEAR(m->partitions);
+   ACLEAR(m->active_parts);
+
+   for (int i = 0; i < MAX_THREADS; i++) {
+      if (m->txbufs[i] != NULL) {
+         tlab_release(&(m->txbufs[i]->tlab));
+         free(m->txbufs[i]->data);
+         free(m->txbufs[i]);
+      }
+   }
+
+   for (rt_watch_t *it = m->watches, *tmp; it; it = tmp) {
+      tmp = it->chain_all;
+      rt_free(m->watch_stack, it);
+   }
+
+   for (int i = 0; i < RT_LAST_EVENT; i++) {
+      for (callback_t *it = m->global_cbs[i], *tmp; it; it = tmp) {
+         tmp = it->next;
+         rt_free(m->callback_stack, it);
+      }
+   }
+
+   rt_alloc_stack_destroy(m->event_stack);
+   rt_alloc_stack_destroy(m->sens_list_stack);
+   rt_alloc_stack_destroy(m->watch_stack);
+   rt_alloc_stack_destroy(m->callback_stack);
+
+   for (memblock_t *mb = m->memblocks, *tmp; mb; mb = tmp) {
+      tmp = mb->chain;
+      nvc_munmap(mb->ptr, MEMBLOCK_PAGE_SZ);
+      free(mb);
+   }
+
+   wheel_free(m->eventq);
+   hash_free(m->scopes);
+   ihash_free(m->res_memo);
+   free(m);
 }
 
 rt_signal_t *find_signal(rt_scope_t *scope, tree_t decl)
@@ -624,13 +1489,42 @@ rt_scope_t *child_scope(rt_scope_t *scope, tree_t decl)
    return NULL;
 }
 
+static void refresh_nexus(rt_model_t *m, rt_nexus_t *n)
+{
+   // Calculate the current value of a net whose updates were skipped
+   // while nothing was observing it
+   TRACE("refresh stale nexus %s", istr(tree_ident(n->signal->where)));
+
+   const bool own_tlab = !tlab_valid(__nvc_tlab);
+   if (own_tlab)
+      tlab_acquire(m->mspace, &__nvc_tlab);
+
+   n->flags &= ~NET_F_STALE;
+   propagate_nexus(n, driving_value(n));
+
+   if (own_tlab)
+      tlab_reset(__nvc_tlab);
+}
+
+static void refresh_signal(rt_signal_t *s)
+{
+   rt_nexus_t *n = &(s->nexus);
+   for (unsigned i = 0; i < s->n_nexus; i++, n = n->chain) {
+      if (unlikely(n->flags & NET_F_STALE))
+         refresh_nexus(get_model(), n);
+   }
+}
+
 const void *signal_value(rt_signal_t *s)
 {
+   refresh_signal(s);
    return s->shared.data;
 }
 
 size_t signal_expand(rt_signal_t *s, int offset, uint64_t *buf, size_t max)
 {
+   refresh_signal(s);
+
    rt_nexus_t *n = &(s->nexus);
    for (; offset > 0; n = n->chain)
       offset -= n->width;
@@ -653,6 +1547,8 @@ size_t signal_expand(rt_signal_t *s, int offset, uint64_t *buf, size_t max)
 
 size_t signal_string(rt_signal_t *s, const char *map, char *buf, size_t max)
 {
+   refresh_signal(s);
+
    char *endp = buf + max;
    int offset = 0;
    rt_nexus_t *n = &(s->nexus);
@@ -692,13 +1588,15 @@ static void deltaq_insert_proc(rt_model_t *m, uint64_t delta, rt_proc_t *wake)
       m->next_is_delta = true;
    }
    else {
+      assert(wake->timeout == NULL);
+
       event_t *e = rt_alloc(m->event_stack);
-      e->when            = m->now + delta;
-      e->kind            = EVENT_PROCESS;
-      e->proc.wakeup_gen = wake->wakeable.wakeup_gen;
-      e->proc.proc       = wake;
+      e->when      = m->now + delta;
+      e->kind      = EVENT_PROCESS;
+      e->proc.proc = wake;
+      e->proc.node = wheel_insert(m->eventq, e->when, e);
 
-      heap_insert(m->eventq_heap, e->when, e);
+      wake->timeout = e;
    }
 }
 
@@ -716,7 +1614,7 @@ static void deltaq_insert_driver(rt_model_t *m, uint64_t delta,
       e->driver.nexus  = nexus;
       e->driver.source = source;
 
-      heap_insert(m->eventq_heap, e->when, e);
+      wheel_insert(m->eventq, e->when, e);
    }
 }
 
@@ -734,7 +1632,7 @@ static void deltaq_insert_force_release(rt_model_t *m, uint64_t delta,
       e->driver.nexus  = nexus;
       e->driver.source = NULL;
 
-      heap_insert(m->eventq_heap, e->when, e);
+      wheel_insert(m->eventq, e->when, e);
    }
 }
 
@@ -752,7 +1650,7 @@ static void deltaq_insert_disconnect(rt_model_t *m, uint64_t delta,
       e->driver.nexus  = source->u.driver.nexus;
       e->driver.source = source;
 
-      heap_insert(m->eventq_heap, e->when, e);
+      wheel_insert(m->eventq, e->when, e);
    }
 }
 
@@ -778,8 +1676,79 @@ static void reset_process(rt_model_t *m, rt_proc_t *proc)
       m->force_stop = true;
 }
 
+static void learn_clock(rt_model_t *m, rt_proc_t *proc)
+{
+   rt_clock_t *c = proc->clock;
+
+   if (c->signal == NULL) {
+      for (rt_scope_t *s = proc->scope; s && !c->signal; s = s->parent)
+         c->signal = find_signal(s, c->decl);
+
+      // The process must run normally if statement coverage is enabled
+      // or the signal has an unexpected layout
+      rt_nexus_t *n = c->signal ? &(c->signal->nexus) : NULL;
+      if (n == NULL || m->cover != NULL || c->signal->n_nexus != 1
+          || n->width != 1 || n->size != 1) {
+         TRACE("cannot run %s as clock process", istr(proc->name));
+         free(c);
+         proc->clock = NULL;
+         return;
+      }
+   }
+
+   rt_nexus_t *n = &(c->signal->nexus);
+   rt_source_t *d = find_driver(n);
+   if (d == NULL || !d->pending)
+      return;
+
+   // The transaction just scheduled is always last in the queue
+   waveform_t *w = &(d->u.driver.pending);
+   while (w->next != NULL)
+      w = w->next;
+
+   const uint8_t cur = *(uint8_t *)n->resolved;
+   if (w->when == m->now + c->after && cur < c->nlits) {
+      TRACE("clock process %s maps %d to %d", istr(proc->name), cur,
+            w->value.bytes[0]);
+      c->next[cur] = w->value.bytes[0];
+   }
+}
+
+static bool run_clock(rt_model_t *m, rt_proc_t *proc)
+{
+   rt_clock_t *c = proc->clock;
+   if (c->signal == NULL || active_txbuf != NULL)
+      return false;
+
+   const uint8_t cur = *(uint8_t *)c->signal->nexus.resolved;
+   if (cur >= c->nlits || c->next[cur] < 0)
+      return false;
+
+   TRACE("run clock process %s", istr(proc->name));
+
+   const uint64_t start_ns = m->profile ? get_thread_cpu_ns() : 0;
+
+   active_proc = proc;
+   active_scope = proc->scope;
+
+   sched_waveform_s(m, c->signal, 0, c->next[cur], c->after, c->reject);
+
+   active_proc = NULL;
+
+   if (m->profile) {
+      proc->prof_runs++;
+      proc->prof_ns += get_thread_cpu_ns() - start_ns;
+   }
+
+   return true;
+}
+
 static void run_process(rt_model_t *m, rt_proc_t *proc)
 {
+   // Free-running clock generators do not need to resume the process
+   if (proc->clock != NULL && run_clock(m, proc))
+      return;
+
    TRACE("run %sprocess %s", proc->privdata ? "" :  "stateless ",
          istr(proc->name));
 
@@ -808,8 +1777,19 @@ static void run_process(rt_model_t *m, rt_proc_t *proc)
       .pointer = mptr_get(m->mspace, proc->scope->privdata)
    };
 
+   const uint64_t start_ns = m->profile ? get_thread_cpu_ns() : 0;
+
    if (!jit_fastcall(m->jit, proc->handle, &result, state, context))
-      m->force_stop = true;
+      relaxed_store(&m->force_stop, true);
+
+   if (m->profile) {
+      // A process never runs on more than one thread at a time
+      proc->prof_runs++;
+      proc->prof_ns += get_thread_cpu_ns() - start_ns;
+   }
+
+   if (proc->clock != NULL && active_txbuf == NULL)
+      learn_clock(m, proc);
 
    active_proc = NULL;
 
@@ -867,6 +1847,41 @@ static void reset_scope(rt_model_t *m, rt_scope_t *s)
       reset_process(m, p);
 }
 
+static bool is_fold_resolution(rt_model_t *m, res_memo_t *memo)
+{
+   // The resolution function can be evaluated for any number of
+   // drivers by folding the memoised two value table over the sources
+   // if the table is associative and the function gives the same
+   // result as the fold for all three value cases.  This is a
+   // heuristic: it assumes a function that agrees with the fold for
+   // three drivers also agrees for four or more, which holds for the
+   // usual resolution functions but is not checked.  Functions that
+   // report or assert during the probe are never folded.
+
+   const int nlits = memo->nlits;
+   for (int i = 0; i < nlits; i++) {
+      for (int j = 0; j < nlits; j++) {
+         for (int k = 0; k < nlits; k++) {
+            const int8_t fold = memo->tab2[(int)memo->tab2[i][j]][k];
+            if (fold != memo->tab2[i][(int)memo->tab2[j][k]])
+               return false;
+
+            int8_t args[3] = { i, j, k };
+            jit_scalar_t result;
+            if (!jit_try_call(m->jit, memo->closure.handle, &result,
+                              memo->closure.context, args, memo->ileft, 3))
+               return false;
+            else if (result.integer != fold)
+               return false;
+            else if (jit_exit_status(m->jit) != 0)
+               return false;   // Reported or asserted with three drivers
+         }
+      }
+   }
+
+   return true;
+}
+
 static res_memo_t *memo_resolution_fn(rt_model_t *m, rt_signal_t *signal,
                                       rt_resolution_t *resolution)
 {
@@ -880,6 +1895,7 @@ static res_memo_t *memo_resolution_fn(rt_model_t *m, rt_signal_t *signal,
    memo->closure = resolution->closure;
    memo->flags   = resolution->flags;
    memo->ileft   = resolution->ileft;
+   memo->nlits   = resolution->nlits;
 
    ihash_put(m->res_memo, memo->closure.handle, memo);
 
@@ -923,6 +1939,8 @@ static res_memo_t *memo_resolution_fn(rt_model_t *m, rt_signal_t *signal,
       memo->flags |= R_MEMO;
       if (identity)
          memo->flags |= R_IDENT;
+      if (is_fold_resolution(m, memo))
+         memo->flags |= R_FOLD;
    }
 
    TRACE("memoised resolution function %s for type %s",
@@ -937,6 +1955,131 @@ static res_memo_t *memo_resolution_fn(rt_model_t *m, rt_signal_t *signal,
    return memo;
 }
 
+static void memo_conversion_fn(rt_model_t *m, rt_conv_func_t *cf,
+                               type_t type)
+{
+   // Memoise conversion functions from a small enumerated type by
+   // evaluating them for every literal up front
+
+   if (cf->insz != 1 || !type_is_enum(type))
+      return;
+
+   const unsigned nlits = type_enum_literals(type_base_recur(type));
+   if (nlits * cf->bufsz > 4096)
+      return;
+
+   uint8_t *memo = static_alloc(m, nlits * cf->bufsz);
+
+   const vhdl_severity_t old_severity = get_exit_severity();
+   set_exit_severity(SEVERITY_NOTE);
+
+   jit_set_silent(m->jit, true);
+
+   jit_scalar_t context = { .pointer = cf->closure.context };
+   for (unsigned i = 0; i < nlits; i++) {
+      uint8_t arg = i;
+      if (!jit_try_call_packed(m->jit, cf->closure.handle, context, &arg, 1,
+                               memo + i * cf->bufsz, cf->bufsz))
+         break;
+   }
+
+   if (jit_exit_status(m->jit) == 0) {
+      cf->memo  = memo;
+      cf->nlits = nlits;
+
+      TRACE("memoised conversion function %s for type %s",
+            istr(jit_get_name(m->jit, cf->closure.handle)), type_pp(type));
+   }
+
+   jit_set_silent(m->jit, false);
+   jit_reset_exit_status(m->jit);
+
+   set_exit_severity(old_severity);
+}
+
+static tree_t signal_root_decl(rt_signal_t *s)
+{
+   if (s->parent->kind != SCOPE_SIGNAL)
+      return s->where;
+
+   rt_scope_t *root = s->parent;
+   while (root->parent->kind == SCOPE_SIGNAL)
+      root = root->parent;
+
+   return root->where;
+}
+
+static bool is_silent_conversion(tree_t conv)
+{
+   switch (tree_kind(conv)) {
+   case T_TYPE_CONV:
+      return true;
+   case T_CONV_FUNC:
+      return is_silent_subprogram(tree_ref(conv), SILENT_CALL_DEPTH);
+   default:
+      return false;
+   }
+}
+
+static bool conversion_is_silent(rt_scope_t *scope, rt_signal_t *src,
+                                 rt_signal_t *dst)
+{
+   // Find the conversion functions in the port map for the port
+   // being mapped: the result may only be cached or memoised if
+   // skipping calls to these cannot change the output of the
+   // simulation
+
+   while (scope != NULL && scope->kind == SCOPE_SIGNAL)
+      scope = scope->parent;
+
+   if (scope == NULL || scope->kind != SCOPE_INSTANCE)
+      return false;
+
+   tree_t block = scope->where;
+   tree_t src_decl = signal_root_decl(src), dst_decl = signal_root_decl(dst);
+
+   bool found = false;
+   const int nparams = tree_params(block);
+   for (int i = 0; i < nparams; i++) {
+      tree_t map = tree_param(block, i), port = NULL, name_conv = NULL;
+      if (tree_subkind(map) == P_POS)
+         port = tree_port(block, tree_pos(map));
+      else {
+         tree_t name = tree_name(map);
+         const tree_kind_t kind = tree_kind(name);
+         if (kind == T_CONV_FUNC || kind == T_TYPE_CONV) {
+            name_conv = name;
+            name = tree_value(name);
+         }
+
+         tree_t ref = name_to_ref(name);
+         if (ref == NULL || !tree_has_ref(ref))
+            continue;
+
+         port = tree_ref(ref);
+      }
+
+      if (port == dst_decl) {
+         // Conversion of the actual for an input
+         tree_t value = tree_value(map);
+         const tree_kind_t kind = tree_kind(value);
+         if (kind == T_CONV_FUNC || kind == T_TYPE_CONV) {
+            if (!is_silent_conversion(value))
+               return false;
+            found = true;
+         }
+      }
+      else if (port == src_decl && name_conv != NULL) {
+         // Conversion of the formal for an output
+         if (!is_silent_conversion(name_conv))
+            return false;
+         found = true;
+      }
+   }
+
+   return found;
+}
+
 static rt_value_t alloc_value(rt_model_t *m, rt_nexus_t *n)
 {
    rt_value_t result = {};
@@ -1021,154 +2164,236 @@ static rt_source_t *add_source(rt_model_t *m, rt_nexus_t *n, source_kind_t kind)
       n->n_sources++;
 
    src->chain_input  = NULL;
-   src->chain_output = NULL;
    src->tag          = kind;
    src->disconnected = 0;
+   src->pending      = 0;
 
    switch (kind) {
    case SOURCE_DRIVER:
       {
          src->u.driver.proc  = NULL;
          src->u.driver.nexus = n;
-
-         waveform_t *w0 = &(src->u.driver.waveforms);
-         w0->when  = 0;
-         w0->next  = NULL;
       }
       break;
 
    case SOURCE_PORT:
-      src->u.port.conv_func = NULL;
-      src->u.port.input     = NULL;
-      src->u.port.output    = n;
+      src->u.port.conv_func    = NULL;
+      src->u.port.input        = NULL;
+      src->u.port.output       = n;
+      src->u.port.chain_output = NULL;
       break;
    }
 
    return src;
 }
 
-static rt_net_t *get_net(rt_model_t *m, rt_nexus_t *nexus)
+static rt_net_t *alloc_net(rt_model_t *m)
 {
-   if (likely(nexus->net != NULL))
-      return nexus->net;
-   else {
-      rt_net_t *net = static_alloc(m, sizeof(rt_net_t));
-      net->pending      = NULL;
-      net->last_active  = TIME_HIGH;
-      net->last_event   = TIME_HIGH;
-      net->active_delta = -1;
-      net->event_delta  = -1;
+   // Nets are allocated from separate chunks so the state updated on
+   // every event is packed together rather than interleaved with the
+   // nexuses and sources
+   if (m->netfree == 0) {
+      m->netchunk = static_alloc(m, NET_CHUNK_SZ * sizeof(rt_net_t));
+      m->netfree  = NET_CHUNK_SZ;
+   }
 
-      static uint32_t next_net_id = 1;
-      net->net_id = next_net_id++;
+   rt_net_t *net = m->netchunk + NET_CHUNK_SZ - (m->netfree--);
+   net->net_id = m->next_net_id++;
 
-      return (nexus->net = net);
-   }
+   return net;
 }
 
-static inline int map_index(rt_index_t *index, unsigned offset)
+static rt_net_t *new_net(rt_model_t *m, rt_nexus_t *nexus)
 {
-   if (likely(index->how >= 0))
-      return offset >> index->how;
-   else
-      return offset / -(index->how);
-}
+   rt_net_t *net;
+   if (m->nets_packed)
+      net = alloc_net(m);
+   else {
+      // Nets created while resetting processes and mapping ports are
+      // moved into chunks by pack_nets once the connectivity is known
+      net = xmalloc(sizeof(rt_net_t));
+      net->net_id = 0;
+   }
 
-static inline int unmap_index(rt_index_t *index, unsigned key)
+   net->pending      = NULL;
+   net->last_active  = TIME_HIGH;
+   net->last_event   = TIME_HIGH;
+   net->active_delta = -1;
+   net->event_delta  = -1;
+
+   return (nexus->net = net);
+}
+
+static void pack_nets(rt_model_t *m, rt_nexus_t *nexus, hash_t *moved)
 {
-   if (likely(index->how >= 0))
-      return key << index->how;
-   else
-      return key * -(index->how);
+   // Place nets in connectivity order so that updating a nexus and the
+   // port outputs it drives touches adjacent memory
+   rt_net_t *old = nexus->net;
+   if (old == NULL)
+      new_net(m, nexus);
+   else if (old->net_id != 0)
+      return;   // Already visited
+   else {
+      // Several nexuses may share a net through port maps
+      rt_net_t *new = hash_get(moved, old);
+      if (new == NULL) {
+         new = alloc_net(m);
+
+         const uint32_t net_id = new->net_id;
+         *new = *old;
+         new->net_id = net_id;
+
+         hash_put(moved, old, new);
+      }
+
+      nexus->net = new;
+   }
+
+   for (rt_source_t *o = nexus->outputs; o; o = o->u.port.chain_output)
+      pack_nets(m, o->u.port.output, moved);
 }
 
-static inline bool index_valid(rt_index_t *index, unsigned offset)
+static rt_net_t *get_net(rt_model_t *m, rt_nexus_t *nexus)
 {
-   if (likely(index->how >= 0))
-      return (offset >> index->how) << index->how == offset;
+   if (likely(nexus->net != NULL))
+      return nexus->net;
+   else if (active_txbuf != NULL || active_partition != NULL) {
+      // Other threads may be reading this nexus concurrently
+      mspace_stop_world(m->mspace);
+      rt_net_t *net = nexus->net ?: new_net(m, nexus);
+      mspace_start_world(m->mspace);
+      return net;
+   }
    else
-      return offset % -(index->how) == 0;
+      return new_net(m, nexus);
+}
+
+static void index_free(rt_index_t *index)
+{
+   if (index == NULL)
+      return;
+
+   for (int i = 0; i < index->nleaves; i++)
+      free(index->leaves[i].nexus);
+
+   free(index->summary[0]);
+   free(index);
+}
+
+static void index_insert(rt_index_t *index, unsigned offset, rt_nexus_t *n)
+{
+   rt_index_leaf_t *leaf = &(index->leaves[offset / 64]);
+   const uint64_t bit = UINT64_C(1) << (offset % 64);
+   assert(!(leaf->map & bit));
+
+   // Pointers to nexuses are packed in order of offset within each leaf
+   const int count = __builtin_popcountll(leaf->map);
+   const int rank = __builtin_popcountll(leaf->map & (bit - 1));
+   leaf->nexus = xrealloc_array(leaf->nexus, count + 1, sizeof(rt_nexus_t *));
+   memmove(leaf->nexus + rank + 1, leaf->nexus + rank,
+           (count - rank) * sizeof(rt_nexus_t *));
+   leaf->nexus[rank] = n;
+
+   const bool was_empty = (leaf->map == 0);
+   leaf->map |= bit;
+
+   // Mark the leaf as non-empty in each level of the summary bitmap
+   for (unsigned key = offset / 64, level = 0;
+        was_empty && level < index->nlevels; key /= 64, level++) {
+      uint64_t *word = &(index->summary[level][key / 64]);
+      if (*word & (UINT64_C(1) << (key % 64)))
+         break;
+      *word |= UINT64_C(1) << (key % 64);
+   }
+}
+
+static int index_pred(rt_index_t *index, int level, int key)
+{
+   // Find the greatest set bit less than or equal to key at this level
+   // of the summary bitmap or -1 if none
+   const uint64_t *bits = index->summary[level];
+   const int word = key / 64;
+   const uint64_t mask = bits[word] & (~UINT64_C(0) >> (63 - key % 64));
+
+   if (mask != 0)
+      return word * 64 + 63 - __builtin_clzll(mask);
+   else if (word == 0)
+      return -1;
+
+   const int prev = index_pred(index, level + 1, word - 1);
+   if (prev < 0)
+      return -1;
+
+   assert(bits[prev] != 0);
+   return prev * 64 + 63 - __builtin_clzll(bits[prev]);
 }
 
 static void build_index(rt_signal_t *signal)
 {
+   // Each leaf of the index covers 64 elements with a bitmap marking
+   // the offsets where a nexus starts and there is a hierarchical
+   // summary bitmap of non-empty leaves so the nexus containing any
+   // offset can be found in O(log n) time
    const unsigned signal_w = signal->shared.size / signal->nexus.size;
+   const unsigned nleaves = (signal_w + 63) / 64;
 
-   int shift = INT_MAX, gcd = 0;
-   rt_nexus_t *n = &(signal->nexus);
-   for (int i = 0, offset = 0; i < signal->n_nexus;
-        i++, offset += n->width, n = n->chain) {
-      const int tzc = __builtin_ctz(offset);
-      shift = MIN(shift, tzc);
+   rt_index_t *index = xcalloc_flex(sizeof(rt_index_t), nleaves,
+                                    sizeof(rt_index_leaf_t));
+   index->nleaves = nleaves;
 
-      // Compute greatest common divisor
-      for (int b = offset; b > 0;) {
-         int temp = b;
-         b = gcd % b;
-         gcd = temp;
-      }
+   unsigned nwords[INDEX_MAX_LEVELS], total = 0;
+   for (unsigned bits = nleaves; index->nlevels == 0 || bits > 1;) {
+      assert(index->nlevels < INDEX_MAX_LEVELS);
+      bits = nwords[index->nlevels++] = (bits + 63) / 64;
+      total += bits;
    }
 
-   const int how = gcd > 1 && gcd > (1 << shift) && gcd > 1 ? -gcd : shift;
-   const int count =
-      how < 0 ? (signal_w - how - 1) / -how : (signal_w >> shift) + 1;
+   index->summary[0] = xcalloc_array(total, sizeof(uint64_t));
+   for (int i = 1; i < index->nlevels; i++)
+      index->summary[i] = index->summary[i - 1] + nwords[i - 1];
 
-   TRACE("create index for signal %s how=%d count=%d",
-         istr(tree_ident(signal->where)), how, count);
+   TRACE("create index for signal %s leaves=%u levels=%u",
+         istr(tree_ident(signal->where)), nleaves, index->nlevels);
 
-   rt_index_t *index = xcalloc_flex(sizeof(rt_index_t), count,
-                                    sizeof(rt_nexus_t *));
-   index->how = how;
-
-   n = &(signal->nexus);
+   rt_nexus_t *n = &(signal->nexus);
    for (int i = 0, offset = 0; i < signal->n_nexus;
-        i++, offset += n->width, n = n->chain) {
-      index->nexus[map_index(index, offset)] = n;
-   }
+        i++, offset += n->width, n = n->chain)
+      index_insert(index, offset, n);
 
-   free(signal->index);
+   index_free(signal->index);
    signal->index = index;
 }
 
 static void update_index(rt_signal_t *s, rt_nexus_t *n)
 {
    const unsigned offset = (n->resolved - (void *)s->shared.data) / n->size;
-
-   if (!index_valid(s->index, offset)) {
-      TRACE("rebuild index for %s offset=%d how=%d",
-            istr(tree_ident(s->where)), offset, s->index->how);
-      build_index(s);
-      assert(s->index->nexus[map_index(s->index, offset)] == n);
-   }
-   else {
-      const int elt = map_index(s->index, offset);
-      assert(s->index->nexus[elt] == NULL);
-      s->index->nexus[elt] = n;
-   }
+   index_insert(s->index, offset, n);
 }
 
 static rt_nexus_t *lookup_index(rt_signal_t *s, int *offset)
 {
-   if (likely(offset == 0 || s->index == NULL))
-      return &(s->nexus);
-   else if (!index_valid(s->index, *offset)) {
-      TRACE("invalid index for %s offset=%d how=%d", istr(tree_ident(s->where)),
-            *offset, s->index->how);
-      free(s->index);
-      s->index = NULL;
-      return &(s->nexus);
-   }
-   else {
-      const int key = map_index(s->index, *offset);
-      for (int k = key; k >= 0; k--) {
-         rt_nexus_t *n = s->index->nexus[k];
-         if (n != NULL) {
-            *offset = unmap_index(s->index, key - k);
-            return n;
-         }
-      }
+   if (likely(*offset == 0 || s->index == NULL))
       return &(s->nexus);
+
+   rt_index_t *index = s->index;
+
+   // Find the closest nexus starting at or before this offset
+   int key = *offset / 64;
+   uint64_t mask = index->leaves[key].map
+      & (~UINT64_C(0) >> (63 - *offset % 64));
+   if (mask == 0) {
+      key = index_pred(index, 0, key - 1);
+      assert(key >= 0);   // First element always starts a nexus
+      mask = index->leaves[key].map;
    }
+
+   const rt_index_leaf_t *leaf = &(index->leaves[key]);
+   const int bit = 63 - __builtin_clzll(mask);
+   const int rank = __builtin_popcountll(mask) - 1;
+   assert(rank == __builtin_popcountll(leaf->map & ((UINT64_C(1) << bit) - 1)));
+
+   *offset -= key * 64 + bit;
+   return leaf->nexus[rank];
 }
 
 static waveform_t *alloc_waveform(void)
@@ -1192,44 +2417,51 @@ static waveform_t *alloc_waveform(void)
    }
 }
 
-static void clone_waveform(rt_nexus_t *nexus, waveform_t *w_new,
-                           waveform_t *w_old, int offset)
+static void clone_value(rt_nexus_t *nexus, rt_value_t *v_new,
+                        rt_value_t *v_old, int offset)
 {
-   w_new->when = w_old->when;
-   w_new->next = NULL;
-
    const int split = offset * nexus->size;
    const int oldsz = (offset + nexus->width) * nexus->size;
    const int newsz = nexus->width * nexus->size;
 
    if (split > sizeof(rt_value_t) && newsz > sizeof(rt_value_t)) {
       // Split the external memory with no copying
-      w_new->value.ext = (char *)w_old->value.ext + split;
+      v_new->ext = (char *)v_old->ext + split;
    }
    else if (newsz > sizeof(rt_value_t)) {
       // Wasting up to eight bytes at the start of the the old waveform
-      char *ext = w_old->value.ext;
-      w_old->value.qword = *(uint64_t *)ext;
-      w_new->value.ext = ext + split;
+      char *ext = v_old->ext;
+      v_old->qword = *(uint64_t *)ext;
+      v_new->ext = ext + split;
    }
    else if (split > sizeof(rt_value_t)) {
       // Wasting up to eight bytes at the end of the the old waveform
-      memcpy(w_new->value.bytes, w_old->value.ext + split, newsz);
+      memcpy(v_new->bytes, v_old->ext + split, newsz);
    }
    else if (oldsz > sizeof(rt_value_t)) {
       // The memory backing this waveform is lost now but this can only
       // happen a bounded number of times as nexuses only ever shrink
-      char *ext = w_old->value.ext;
-      memcpy(w_new->value.bytes, ext + split, newsz);
-      w_old->value.qword = *(uint64_t *)ext;
+      char *ext = v_old->ext;
+      memcpy(v_new->bytes, ext + split, newsz);
+      v_old->qword = *(uint64_t *)ext;
    }
    else {
       // This trick with shifting probably only works on little-endian
       // systems
-      w_new->value.qword = w_old->value.qword >> (split * 8);
+      v_new->qword = v_old->qword >> (split * 8);
    }
 }
 
+static void add_driver(rt_proc_t *proc, rt_nexus_t *nexus, rt_source_t *src)
+{
+   if (proc == NULL)
+      return;
+   else if (proc->drivers == NULL)
+      proc->drivers = ihash_new(16);
+
+   ihash_put(proc->drivers, (uintptr_t)nexus, src);
+}
+
 static void clone_source(rt_model_t *m, rt_nexus_t *nexus, rt_source_t *old,
                          int offset, rt_net_t *net)
 {
@@ -1259,21 +2491,31 @@ static void clone_source(rt_model_t *m, rt_nexus_t *nexus, rt_source_t *old,
    case SOURCE_DRIVER:
       {
          new->u.driver.proc = old->u.driver.proc;
+         add_driver(new->u.driver.proc, nexus, new);
 
          // Current transaction
-         waveform_t *w_new = &(new->u.driver.waveforms);
-         waveform_t *w_old = &(old->u.driver.waveforms);
-         w_new->when = w_old->when;
-
-         clone_waveform(nexus, w_new, w_old, offset);
+         clone_value(nexus, &(new->u.driver.value),
+                     &(old->u.driver.value), offset);
 
          // Future transactions
-         for (w_old = w_old->next; w_old; w_old = w_old->next) {
-            w_new = (w_new->next = alloc_waveform());
-            clone_waveform(nexus, w_new, w_old, offset);
+         if (old->pending) {
+            waveform_t *w_old = &(old->u.driver.pending);
+            waveform_t *w_new = &(new->u.driver.pending);
+            new->pending = 1;
+
+            for (;;) {
+               w_new->when = w_old->when;
+               w_new->next = NULL;
+               clone_value(nexus, &(w_new->value), &(w_old->value), offset);
+
+               assert(w_old->when >= m->now);
+               deltaq_insert_driver(m, w_new->when - m->now, nexus, new);
 
-            assert(w_old->when >= m->now);
-            deltaq_insert_driver(m, w_new->when - m->now, nexus, new);
+               if ((w_old = w_old->next) == NULL)
+                  break;
+
+               w_new = (w_new->next = alloc_waveform());
+            }
          }
       }
       break;
@@ -1289,12 +2531,13 @@ static rt_nexus_t *clone_nexus(rt_model_t *m, rt_nexus_t *old, int offset,
    signal->n_nexus++;
 
    rt_nexus_t *new = static_alloc(m, sizeof(rt_nexus_t));
-   new->width    = old->width - offset;
-   new->size     = old->size;
-   new->signal   = signal;
-   new->resolved = (uint8_t *)old->resolved + offset * old->size;
-   new->chain    = old->chain;
-   new->flags    = old->flags;
+   new->width     = old->width - offset;
+   new->size      = old->size;
+   new->signal    = signal;
+   new->resolved  = (uint8_t *)old->resolved + offset * old->size;
+   new->chain     = old->chain;
+   new->flags     = old->flags;
+   new->partition = old->partition;
 
    old->chain = new;
    old->width = offset;
@@ -1335,7 +2578,7 @@ static rt_nexus_t *clone_nexus(rt_model_t *m, rt_nexus_t *old, int offset,
 
    int nth = 0;
    for (rt_source_t *old_o = old->outputs; old_o;
-        old_o = old_o->chain_output, nth++) {
+        old_o = old_o->u.port.chain_output, nth++) {
 
       assert(old_o->tag != SOURCE_DRIVER);
 
@@ -1353,7 +2596,7 @@ static rt_nexus_t *clone_nexus(rt_model_t *m, rt_nexus_t *old, int offset,
                continue;
             else if (s->u.port.input == new || s->u.port.input == old) {
                s->u.port.input = new;
-               s->chain_output = new->outputs;
+               s->u.port.chain_output = new->outputs;
                new->outputs = s;
                break;
             }
@@ -1369,15 +2612,9 @@ static rt_nexus_t *clone_nexus(rt_model_t *m, rt_nexus_t *old, int offset,
    return new;
 }
 
-static rt_nexus_t *split_nexus(rt_model_t *m, rt_signal_t *s,
-                               int offset, int count)
+static rt_nexus_t *find_nexus(rt_model_t *m, rt_signal_t *s,
+                              int offset, int count, bool split)
 {
-   rt_nexus_t *n0 = &(s->nexus);
-   if (likely(offset == 0 && n0->width == count))
-      return n0;
-   else if (offset == 0 && count == s->shared.size / n0->size)
-      return n0;
-
    rt_nexus_t *result = NULL;
    for (rt_nexus_t *it = lookup_index(s, &offset); count > 0; it = it->chain) {
       if (offset >= it->width) {
@@ -1385,13 +2622,20 @@ static rt_nexus_t *split_nexus(rt_model_t *m, rt_signal_t *s,
          continue;
       }
       else if (offset > 0) {
+         if (!split)
+            return NULL;
+
          clone_nexus(m, it, offset, NULL);
          offset = 0;
          continue;
       }
       else {
-         if (it->width > count)
+         if (it->width > count) {
+            if (!split)
+               return NULL;
+
             clone_nexus(m, it, count, NULL);
+         }
 
          count -= it->width;
 
@@ -1403,6 +2647,29 @@ static rt_nexus_t *split_nexus(rt_model_t *m, rt_signal_t *s,
    return result;
 }
 
+static rt_nexus_t *split_nexus(rt_model_t *m, rt_signal_t *s,
+                               int offset, int count)
+{
+   rt_nexus_t *n0 = &(s->nexus);
+   if (likely(offset == 0 && n0->width == count))
+      return n0;
+   else if (offset == 0 && count == s->shared.size / n0->size)
+      return n0;
+   else if (active_txbuf == NULL)
+      return find_nexus(m, s, offset, count, true);
+
+   rt_nexus_t *result = find_nexus(m, s, offset, count, false);
+   if (result == NULL) {
+      // Splitting the nexus modifies state shared with processes
+      // running in other threads
+      mspace_stop_world(m->mspace);
+      result = find_nexus(m, s, offset, count, true);
+      mspace_start_world(m->mspace);
+   }
+
+   return result;
+}
+
 static void setup_signal(rt_model_t *m, rt_signal_t *s, tree_t where,
                          unsigned count, unsigned size, net_flags_t flags,
                          unsigned offset)
@@ -1513,19 +2780,41 @@ static void *call_conversion(rt_port_t *port, value_fn_t fn)
       }
    }
 
+   assert(insz == cf->insz);
+
+   const ptrdiff_t outoff = port->output->signal->shared.offset;
+
+   if (cf->memo != NULL && *(uint8_t *)indata < cf->nlits) {
+      const uint8_t *result = cf->memo + *(uint8_t *)indata * cf->bufsz;
+      if (incopy) free(indata);
+      return (void *)result + outoff;
+   }
+   else if (cf->cacheable && cf->valid
+            && memcmp(indata, cf->lastin, insz) == 0) {
+      // Input unchanged since the last call
+      if (incopy) free(indata);
+      return cf->buffer + outoff;
+   }
+
    rt_model_t *m = get_model();
 
    TRACE("call conversion function %s insz=%zu outsz=%zu",
          istr(jit_get_name(m->jit, cf->closure.handle)), insz, cf->bufsz);
 
    jit_scalar_t context = { .pointer = cf->closure.context };
-   if (!jit_try_call_packed(m->jit, cf->closure.handle, context,
-                            indata, insz, cf->buffer, cf->bufsz))
-      m->force_stop = true;
+   if (jit_try_call_packed(m->jit, cf->closure.handle, context,
+                           indata, insz, cf->buffer, cf->bufsz)) {
+      memcpy(cf->lastin, indata, insz);
+      cf->valid = true;
+   }
+   else {
+      cf->valid = false;
+      relaxed_store(&m->force_stop, true);
+   }
 
    if (incopy) free(indata);
 
-   return cf->buffer + port->output->signal->shared.offset;
+   return cf->buffer + outoff;
 }
 
 static void *source_value(rt_nexus_t *nexus, rt_source_t *src)
@@ -1535,7 +2824,7 @@ static void *source_value(rt_nexus_t *nexus, rt_source_t *src)
       if (unlikely(src->disconnected))
          return NULL;
       else
-         return value_ptr(nexus, &(src->u.driver.waveforms.value));
+         return value_ptr(nexus, &(src->u.driver.value));
 
    case SOURCE_PORT:
       if (likely(src->u.port.conv_func == NULL))
@@ -1547,6 +2836,74 @@ static void *source_value(rt_nexus_t *nexus, rt_source_t *src)
    return NULL;
 }
 
+#ifdef __x86_64__
+__attribute__((target("ssse3")))
+static int memo_lookup1_ssse3(const res_memo_t *r, int8_t *out,
+                              const uint8_t *in, int width)
+{
+   const __m128i tab = _mm_loadu_si128((const __m128i *)r->tab1);
+
+   int j = 0;
+   for (; j + 16 <= width; j += 16) {
+      const __m128i vin = _mm_loadu_si128((const __m128i *)(in + j));
+      _mm_storeu_si128((__m128i *)(out + j), _mm_shuffle_epi8(tab, vin));
+   }
+
+   return j;
+}
+
+__attribute__((target("ssse3")))
+static int memo_lookup2_ssse3(const res_memo_t *r, int8_t *out,
+                              const uint8_t *a, const uint8_t *b, int width)
+{
+   // Shuffle each row of the table by the second operand and then
+   // select the row given by the first operand
+   int j = 0;
+   for (; j + 16 <= width; j += 16) {
+      const __m128i va = _mm_loadu_si128((const __m128i *)(a + j));
+      const __m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+
+      __m128i acc = _mm_setzero_si128();
+      for (int i = 0; i < r->nlits; i++) {
+         const __m128i row = _mm_loadu_si128((const __m128i *)r->tab2[i]);
+         const __m128i sel = _mm_cmpeq_epi8(va, _mm_set1_epi8(i));
+         const __m128i val = _mm_shuffle_epi8(row, vb);
+         acc = _mm_or_si128(acc, _mm_and_si128(sel, val));
+      }
+
+      _mm_storeu_si128((__m128i *)(out + j), acc);
+   }
+
+   return j;
+}
+#endif
+
+static void memo_lookup1(const res_memo_t *r, int8_t *out,
+                         const uint8_t *in, int width)
+{
+   int j = 0;
+#ifdef __x86_64__
+   if (width >= 16 && have_ssse3)
+      j = memo_lookup1_ssse3(r, out, in, width);
+#endif
+
+   for (; j < width; j++)
+      out[j] = r->tab1[in[j]];
+}
+
+static void memo_lookup2(const res_memo_t *r, int8_t *out,
+                         const uint8_t *a, const uint8_t *b, int width)
+{
+   int j = 0;
+#ifdef __x86_64__
+   if (width >= 16 && have_ssse3)
+      j = memo_lookup2_ssse3(r, out, a, b, width);
+#endif
+
+   for (; j < width; j++)
+      out[j] = r->tab2[a[j]][b[j]];
+}
+
 static void *call_resolution(rt_nexus_t *nexus, res_memo_t *r, int nonnull)
 {
    // Find the first non-null source
@@ -1563,28 +2920,26 @@ static void *call_resolution(rt_nexus_t *nexus, res_memo_t *r, int nonnull)
       // Resolution function has been memoised so do a table lookup
 
       void *resolved = local_alloc(nexus->width * nexus->size);
-
-      for (int j = 0; j < nexus->width; j++) {
-         const int index = ((uint8_t *)p0)[j];
-         ((int8_t *)resolved)[j] = r->tab1[index];
-      }
-
+      memo_lookup1(r, resolved, (uint8_t *)p0, nexus->width);
       return resolved;
    }
-   else if ((r->flags & R_MEMO) && nonnull == 2) {
+   else if ((r->flags & R_MEMO) && nonnull >= 2
+            && (nonnull == 2 || (r->flags & R_FOLD))) {
       // Resolution function has been memoised so do a table lookup
+      // for each pair of sources
 
       void *resolved = local_alloc(nexus->width * nexus->size);
+      uint8_t *acc = (uint8_t *)p0;
 
-      char *p1 = NULL;
-      for (rt_source_t *s1 = s0->chain_input;
-           s1 && (p1 = source_value(nexus, s1)) == NULL;
-           s1 = s1->chain_input)
-         ;
-
-      for (int j = 0; j < nexus->width; j++)
-         ((int8_t *)resolved)[j] = r->tab2[(int)p0[j]][(int)p1[j]];
+      for (rt_source_t *s = s0->chain_input; s; s = s->chain_input) {
+         const uint8_t *pn = source_value(nexus, s);
+         if (pn != NULL) {
+            memo_lookup2(r, resolved, acc, pn, nexus->width);
+            acc = resolved;
+         }
+      }
 
+      assert(acc == resolved);
       return resolved;
    }
    else if (r->flags & R_COMPOSITE) {
@@ -1606,7 +2961,7 @@ static void *call_resolution(rt_nexus_t *nexus, res_memo_t *r, int nonnull)
       jit_scalar_t result;
       if (!jit_try_call(m->jit, r->closure.handle, &result,
                         r->closure.context, inputs, r->ileft, nonnull))
-         m->force_stop = true;
+         relaxed_store(&m->force_stop, true);
 
       void *resolved = result.pointer;
       const ptrdiff_t noff =
@@ -1632,7 +2987,7 @@ static void *call_resolution(rt_nexus_t *nexus, res_memo_t *r, int nonnull)
             if (!jit_try_call(m->jit, r->closure.handle, &result,       \
                               r->closure.context, vals, r->ileft,       \
                               nonnull))                                 \
-               m->force_stop = true;                                    \
+               relaxed_store(&m->force_stop, true);                     \
             p[j] = result.integer;                                      \
          } while (0)
 
@@ -1667,7 +3022,7 @@ static void *driving_value(rt_nexus_t *nexus)
          // signal, then the driving value of S is the current value of
          // that driver.
          assert(!s->disconnected);
-         return value_ptr(nexus, &(s->u.driver.waveforms.value));
+         return value_ptr(nexus, &(s->u.driver.value));
       }
       else {
          // If S has one source that is a port and S is not a resolved
@@ -1710,7 +3065,7 @@ static const void *effective_value(rt_nexus_t *nexus)
    // value of S is the same as the effective value of the actual part
    // of the association element that associates an actual with S
    if (nexus->flags & NET_F_INOUT) {
-      for (rt_source_t *s = nexus->outputs; s; s = s->chain_output) {
+      for (rt_source_t *s = nexus->outputs; s; s = s->u.port.chain_output) {
          if (s->tag == SOURCE_PORT) {
             if (likely(s->u.port.conv_func == NULL))
                return effective_value(s->u.port.output);
@@ -1746,6 +3101,24 @@ static void propagate_nexus(rt_nexus_t *nexus, const void *resolved)
       memcpy(nexus->resolved, resolved, valuesz);
 }
 
+static void collapse_port(rt_nexus_t *nexus)
+{
+   // A nexus whose only source is a port without a conversion function
+   // always has the same driving value as the actual so a new value can
+   // be passed straight down a chain of these without walking back up
+   // to the driver at each level of the hierarchy
+   if (nexus->n_sources != 1 || nexus->sources.tag != SOURCE_PORT)
+      return;
+   else if (nexus->sources.u.port.conv_func != NULL)
+      return;
+   else if (nexus->signal->resolution != NULL)
+      return;
+   else if (nexus->flags & NET_F_EFFECTIVE)
+      return;
+
+   nexus->flags |= NET_F_COLLAPSED;
+}
+
 static int nexus_rank(rt_nexus_t *nexus)
 {
    if (nexus->n_sources > 0) {
@@ -1767,6 +3140,9 @@ static void reset_coverage(rt_model_t *m)
    if ((m->cover = cover_read_tags(m->top)) == NULL)
       return;
 
+   // Coverage counters are not updated atomically
+   m->parallel = false;
+
    int32_t n_stmts, n_conds;
    cover_count_tags(m->cover, &n_stmts, &n_conds);
 
@@ -1803,7 +3179,7 @@ static void dump_one_signal(rt_model_t *m, rt_scope_t *scope, rt_signal_t *s,
 
    for (int nth = 0; nth < s->n_nexus; nth++, n = n->chain) {
       int n_outputs = 0;
-      for (rt_source_t *s = n->outputs; s != NULL; s = s->chain_output)
+      for (rt_source_t *s = n->outputs; s != NULL; s = s->u.port.chain_output)
          n_outputs++;
 
       void *driving = NULL;
@@ -1858,123 +3234,796 @@ static void dump_signals(rt_model_t *m, rt_scope_t *scope)
       dump_signals(m, c);
 }
 
-void model_reset(rt_model_t *m)
+static rt_partition_t *find_partition(rt_partition_t *p)
 {
-   MODEL_ENTRY(m);
-
-   // Initialisation is described in LRM 93 section 12.6.4
+   while (p->parent != p) {
+      p->parent = p->parent->parent;   // Path halving
+      p = p->parent;
+   }
 
-   reset_coverage(m);
-   reset_scope(m, m->root);
+   return p;
+}
 
-   if (m->force_stop)
-      return;   // Error in intialisation
+static void merge_partitions(rt_nexus_t *a, rt_nexus_t *b)
+{
+   rt_partition_t *pa = find_partition(a->partition);
+   rt_partition_t *pb = find_partition(b->partition);
 
-#if TRACE_SIGNALS > 0
-   if (__trace_on)
-      dump_signals(m, m->root);
-#endif
+   if (pa != pb)
+      pb->parent = pa;
+}
 
-   TRACE("calculate initial signal values");
+static void merge_scope_partitions(rt_nexus_t *n, rt_scope_t *scope)
+{
+   for (rt_signal_t *s = scope->signals; s; s = s->chain) {
+      rt_nexus_t *it = &(s->nexus);
+      for (unsigned i = 0; i < s->n_nexus; i++, it = it->chain)
+         merge_partitions(n, it);
+   }
 
-   // The signals in the model are updated as follows in an order such
-   // that if a given signal R depends upon the current value of another
-   // signal S, then the current value of S is updated prior to the
-   // updating of the current value of R.
+   for (rt_scope_t *c = scope->child; c; c = c->chain)
+      merge_scope_partitions(n, c);
+}
 
-   heap_t *q = heap_new(MAX(m->n_signals + 1, 128));
+static void build_partitions(rt_model_t *m)
+{
+   SCOPED_A(rt_partition_t *) all = AINIT;
 
    for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain) {
-      // The initial value of each driver is the default value of the signal
-      if (n->n_sources > 0) {
-         for (rt_source_t *s = &(n->sources); s; s = s->chain_input) {
-            if (s->tag == SOURCE_DRIVER)
-               copy_value_ptr(n, &(s->u.driver.waveforms.value), n->resolved);
-         }
-      }
-
-      heap_insert(q, nexus_rank(n), n);
+      n->partition = xcalloc(sizeof(rt_partition_t));
+      n->partition->parent = n->partition;
+      APUSH(all, n->partition);
    }
 
-   SCOPED_A(rt_nexus_t *) effq = AINIT;
-
-   while (heap_size(q) > 0) {
-      rt_nexus_t *n = heap_extract_min(q);
+   for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain) {
+      if (n->n_sources == 0)
+         continue;
 
-      if (n->flags & NET_F_EFFECTIVE) {
-         // Driving and effective values must be calculated separately
-         void *driving = n->resolved + 2*n->signal->shared.size;
-         memcpy(driving, driving_value(n), n->width * n->size);
+      for (rt_source_t *s = &(n->sources); s; s = s->chain_input) {
+         if (s->tag != SOURCE_PORT)
+            continue;
 
-         APUSH(effq, n);
+         merge_partitions(n, s->u.port.input);
 
-         TRACE("%s initial driving value %s",
-               istr(tree_ident(n->signal->where)), fmt_nexus(n, driving));
+         if (s->u.port.conv_func != NULL) {
+            // Conversion functions read the whole input signal
+            rt_signal_t *i0 = s->u.port.input->signal;
+            if (i0->parent->kind == SCOPE_SIGNAL) {
+               rt_scope_t *root = i0->parent;
+               while (root->parent->kind == SCOPE_SIGNAL)
+                  root = root->parent;
+
+               merge_scope_partitions(n, root);
+            }
+            else {
+               rt_nexus_t *it = &(i0->nexus);
+               for (unsigned i = 0; i < i0->n_nexus; i++, it = it->chain)
+                  merge_partitions(n, it);
+            }
+         }
       }
-      else {
-         // Effective value is always the same as the driving value
-         const void *initial = n->resolved;
-         if (n->n_sources > 0)
-            initial = driving_value(n);
+   }
 
-         propagate_nexus(n, initial);
+   // Resolving any part of a composite signal with a resolution
+   // function reads the sources of every sub-signal
+   hset_t *roots = hset_new(64);
+   for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain) {
+      rt_scope_t *root = n->signal->parent;
+      if (root->kind != SCOPE_SIGNAL)
+         continue;
 
-         TRACE("%s initial value %s", istr(tree_ident(n->signal->where)),
-               fmt_nexus(n, initial));
+      bool resolved = !!(root->flags & SCOPE_F_RESOLVED);
+      while (root->parent->kind == SCOPE_SIGNAL) {
+         root = root->parent;
+         resolved |= !!(root->flags & SCOPE_F_RESOLVED);
       }
-   }
 
-   heap_free(q);
+      if (resolved && !hset_contains(roots, root)) {
+         merge_scope_partitions(n, root);
+         hset_insert(roots, root);
+      }
+   }
+   hset_free(roots);
 
-   // Update effective values after all initial driving values calculated
-   for (int i = 0; i < effq.count; i++) {
-      rt_nexus_t *n = effq.items[i];
+   for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain)
+      n->partition = find_partition(n->partition);
 
-      const void *initial = effective_value(n);
-      propagate_nexus(n, initial);
+   for (int i = 0; i < all.count; i++) {
+      if (all.items[i]->parent == all.items[i])
+         APUSH(m->partitions, all.items[i]);
+      else
+         free(all.items[i]);
+   }
 
-      TRACE("%s initial effective value %s", istr(tree_ident(n->signal->where)),
-            fmt_nexus(n, initial));
+   TRACE("%d nexuses in %d partitions", all.count, m->partitions.count);
+}
+
+static bool is_delta_attribute(tree_t t)
+{
+   switch (tree_subkind(t)) {
+   case ATTR_EVENT:
+   case ATTR_ACTIVE:
+   case ATTR_LAST_EVENT:
+   case ATTR_LAST_ACTIVE:
+   case ATTR_LAST_VALUE:
+   case ATTR_DRIVING:
+   case ATTR_DRIVING_VALUE:
+   case ATTR_DELAYED:
+   case ATTR_STABLE:
+   case ATTR_QUIET:
+   case ATTR_TRANSACTION:
+      return true;   // Can observe delta cycles
+   default:
+      return false;
    }
 }
 
-static bool is_stale_event(event_t *e)
+static bool has_signal_ports(tree_t call)
 {
-   return (e->kind == EVENT_PROCESS)
-      && (e->proc.wakeup_gen != e->proc.proc->wakeable.wakeup_gen);
+   // Subprograms such as rising_edge with signal parameters may read
+   // attributes of the actual signal
+   tree_t decl = tree_ref(call);
+   if (!is_subprogram(decl) || tree_kind(decl) == T_GENERIC_DECL)
+      return false;
+
+   const int nports = tree_ports(decl);
+   for (int i = 0; i < nports; i++) {
+      if (tree_class(tree_port(decl, i)) == C_SIGNAL)
+         return true;
+   }
+
+   return false;
 }
 
-static void sched_event(rt_model_t *m, sens_list_t **list,
-                        rt_wakeable_t *obj, bool recur)
+static void combinational_cb(tree_t t, void *context)
 {
-   // See if there is already a stale entry in the pending list for this
-   // object
-   sens_list_t *it = *list;
-   int count = 0;
-   for (; it != NULL; it = it->next, ++count) {
-      if ((it->wake == obj) && (it->wakeup_gen != obj->wakeup_gen))
-         break;
-   }
+   bool *comb = context;
 
-   if (it == NULL) {
-      sens_list_t *node = rt_alloc(m->sens_list_stack);
-      node->wake       = obj;
-      node->wakeup_gen = obj->wakeup_gen;
-      node->next       = *list;
-      node->recur      = recur;
+   switch (tree_kind(t)) {
+   case T_WAVEFORM:
+      if (tree_has_delay(t)) {
+         int64_t delay;
+         if (!folded_int(tree_delay(t), &delay) || delay != 0)
+            *comb = false;
+      }
+      break;
 
-      *list = node;
-   }
-   else {
-      // Reuse the stale entry
-      it->wakeup_gen = obj->wakeup_gen;
+   case T_ATTR_REF:
+      if (is_delta_attribute(t))
+         *comb = false;
+      break;
+
+   case T_FCALL:
+      if (has_signal_ports(t))
+         *comb = false;
+      break;
+
+   case T_PCALL:
+   case T_PROT_PCALL:
+   case T_PROT_FCALL:
+   case T_FORCE:
+   case T_RELEASE:
+      *comb = false;
+      break;
+
+   default:
+      break;
    }
 }
 
-static rt_source_t *find_driver(rt_nexus_t *nexus)
+static bool is_combinational_process(rt_proc_t *p)
 {
-   // Try to find this process in the list of existing drivers
-   for (rt_source_t *d = &(nexus->sources); d; d = d->chain_input) {
+   // A combinational process is only sensitive to a static list of
+   // signals and all its assignments have zero delay so it may run as
+   // soon as all the processes driving its inputs have run
+
+   if (p->wakeable.postponed || p->clock != NULL)
+      return false;
+
+   const int nstmts = tree_stmts(p->where);
+   if (nstmts == 0)
+      return false;
+
+   tree_t wait = tree_stmt(p->where, nstmts - 1);
+   if (tree_kind(wait) != T_WAIT || !(tree_flags(wait) & TREE_F_STATIC_WAIT))
+      return false;
+
+   bool comb = true;
+   tree_visit(p->where, combinational_cb, &comb);
+   return comb;
+}
+
+typedef struct {
+   rt_proc_t *from;
+   rt_proc_t *to;
+} level_edge_t;
+
+typedef struct {
+   hash_t                *leaders;
+   A(rt_proc_t *)         procs;
+   A(level_edge_t)        edges;
+} level_ctx_t;
+
+static void level_collect(level_ctx_t *ctx, rt_scope_t *s)
+{
+   for (rt_proc_t *p = s->procs; p != NULL; p = p->chain) {
+      if (p->follower)
+         continue;
+
+      // Processes fused together are levelised as a single unit
+      bool comb = true;
+      for (rt_proc_t *it = p; it && comb; it = it->fused)
+         comb = is_combinational_process(it);
+
+      if (comb) {
+         for (rt_proc_t *it = p; it; it = it->fused)
+            hash_put(ctx->leaders, it, p);
+
+         APUSH(ctx->procs, p);
+      }
+   }
+
+   for (rt_scope_t *c = s->child; c != NULL; c = c->chain)
+      level_collect(ctx, c);
+}
+
+static void level_readers(level_ctx_t *ctx, rt_proc_t *from, rt_nexus_t *n)
+{
+   if (n->net != NULL) {
+      for (sens_list_t *it = n->net->pending; it; it = it->next) {
+         if (it->wake->kind != W_PROC || !it->recur)
+            continue;
+
+         rt_proc_t *to = container_of(it->wake, rt_proc_t, wakeable);
+         if (hash_get(ctx->leaders, to) == to)
+            APUSH(ctx->edges, ((level_edge_t){ from, to }));
+      }
+   }
+
+   for (rt_source_t *o = n->outputs; o; o = o->u.port.chain_output)
+      level_readers(ctx, from, o->u.port.output);
+}
+
+static void observed_cb(tree_t t, void *context)
+{
+   hset_t *decls = context;
+
+   switch (tree_kind(t)) {
+   case T_ATTR_REF:
+      if (is_delta_attribute(t)) {
+         tree_t ref = name_to_ref(tree_name(t));
+         if (ref != NULL && tree_has_ref(ref))
+            hset_insert(decls, tree_ref(ref));
+      }
+      break;
+
+   case T_FCALL:
+   case T_PCALL:
+   case T_PROT_FCALL:
+   case T_PROT_PCALL:
+      if (tree_has_ref(t) && has_signal_ports(t)) {
+         const int nparams = tree_params(t);
+         for (int i = 0; i < nparams; i++) {
+            tree_t ref = name_to_ref(tree_value(tree_param(t, i)));
+            if (ref != NULL && tree_has_ref(ref))
+               hset_insert(decls, tree_ref(ref));
+         }
+      }
+      break;
+
+   default:
+      break;
+   }
+}
+
+static void observed_procs(rt_scope_t *s, hset_t *decls)
+{
+   for (rt_proc_t *p = s->procs; p != NULL; p = p->chain)
+      tree_visit(p->where, observed_cb, decls);
+
+   for (rt_scope_t *c = s->child; c != NULL; c = c->chain)
+      observed_procs(c, decls);
+}
+
+static void observed_signals(rt_scope_t *s, hset_t *decls, hset_t *observed)
+{
+   for (rt_signal_t *sig = s->signals; sig; sig = sig->chain) {
+      if (hset_contains(decls, sig->where))
+         hset_insert(observed, sig);
+   }
+
+   for (rt_alias_t *a = s->aliases; a; a = a->chain) {
+      if (hset_contains(decls, a->where))
+         hset_insert(observed, a->signal);
+   }
+
+   for (rt_scope_t *c = s->child; c != NULL; c = c->chain)
+      observed_signals(c, decls, observed);
+}
+
+static bool is_observed_nexus(rt_nexus_t *n, hset_t *observed)
+{
+   // Delta cycles must remain visible on a nexus whose attributes are
+   // read, which feeds an implicit signal or postponed process, or
+   // which has a watch callback
+   if (hset_contains(observed, n->signal))
+      return true;
+
+   if (n->net != NULL) {
+      for (sens_list_t *it = n->net->pending; it; it = it->next) {
+         if (it->wake->kind != W_PROC || it->wake->postponed)
+            return true;
+      }
+   }
+
+   for (rt_source_t *o = n->outputs; o; o = o->u.port.chain_output) {
+      if (is_observed_nexus(o->u.port.output, observed))
+         return true;
+   }
+
+   return false;
+}
+
+static void delevelise_nexus(rt_nexus_t *n)
+{
+   // Called when a watch is added after the processes were levelised
+   if (n->n_sources == 0)
+      return;
+
+   for (rt_source_t *s = &(n->sources); s; s = s->chain_input) {
+      if (s->tag == SOURCE_PORT)
+         delevelise_nexus(s->u.port.input);
+      else {
+         for (rt_proc_t *it = s->u.driver.proc; it; it = it->fused)
+            it->level = 0;
+      }
+   }
+}
+
+static int level_edge_cmp(const void *a, const void *b)
+{
+   const level_edge_t *ea = a, *eb = b;
+   if (ea->from != eb->from)
+      return (uintptr_t)ea->from < (uintptr_t)eb->from ? -1 : 1;
+   else
+      return 0;
+}
+
+static void levelise_processes(rt_model_t *m)
+{
+   // Assign each combinational process a level one greater than any
+   // combinational process driving one of its inputs: these processes
+   // then run in level order within a single cycle and any process on
+   // a combinational loop is scheduled normally
+
+   level_ctx_t ctx = {
+      .leaders = hash_new(256),
+   };
+
+   level_collect(&ctx, m->root);
+
+   hset_t *decls = hset_new(128), *observed = hset_new(128);
+   observed_procs(m->root, decls);
+   observed_signals(m->root, decls, observed);
+
+   // Processes driving an observed nexus are scheduled normally
+   for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain) {
+      if (n->n_sources == 0)
+         continue;
+
+      for (rt_source_t *s = &(n->sources); s; s = s->chain_input) {
+         if (s->tag != SOURCE_DRIVER)
+            continue;
+
+         rt_proc_t *leader = hash_get(ctx.leaders, s->u.driver.proc);
+         if (leader != NULL && is_observed_nexus(n, observed)) {
+            for (rt_proc_t *it = leader; it; it = it->fused)
+               hash_put(ctx.leaders, it, NULL);
+         }
+      }
+   }
+
+   hset_free(decls);
+   hset_free(observed);
+
+   int wptr = 0;
+   for (int i = 0; i < ctx.procs.count; i++) {
+      rt_proc_t *p = ctx.procs.items[i];
+      if (hash_get(ctx.leaders, p) == p)
+         ctx.procs.items[wptr++] = p;
+   }
+   ATRIM(ctx.procs, wptr);
+
+   for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain) {
+      if (n->n_sources == 0)
+         continue;
+
+      for (rt_source_t *s = &(n->sources); s; s = s->chain_input) {
+         if (s->tag != SOURCE_DRIVER)
+            continue;
+
+         rt_proc_t *from = hash_get(ctx.leaders, s->u.driver.proc);
+         if (from != NULL)
+            level_readers(&ctx, from, n);
+      }
+   }
+
+   qsort(ctx.edges.items, ctx.edges.count, sizeof(level_edge_t),
+         level_edge_cmp);
+
+   ihash_t *indegree = ihash_new(256);
+   for (int i = 0; i < ctx.edges.count; i++) {
+      rt_proc_t *to = ctx.edges.items[i].to;
+      const uintptr_t count = (uintptr_t)ihash_get(indegree, (uintptr_t)to);
+      ihash_put(indegree, (uintptr_t)to, (void *)(count + 1));
+   }
+
+   A(rt_proc_t *) ready = AINIT;
+   for (int i = 0; i < ctx.procs.count; i++) {
+      rt_proc_t *p = ctx.procs.items[i];
+      if (ihash_get(indegree, (uintptr_t)p) == NULL) {
+         p->level = 1;
+         APUSH(ready, p);
+      }
+   }
+
+   unsigned nlevelised = 0, maxlevel = 0;
+   while (ready.count > 0) {
+      rt_proc_t *p = APOP(ready);
+      nlevelised++;
+      maxlevel = MAX(maxlevel, p->level);
+
+      const level_edge_t key = { .from = p };
+      level_edge_t *e = bsearch(&key, ctx.edges.items, ctx.edges.count,
+                                sizeof(level_edge_t), level_edge_cmp);
+      if (e == NULL)
+         continue;
+
+      while (e > ctx.edges.items && (e - 1)->from == p)
+         e--;
+
+      for (; e < ctx.edges.items + ctx.edges.count && e->from == p; e++) {
+         rt_proc_t *to = e->to;
+         to->level = MAX(to->level, p->level + 1);
+
+         const uintptr_t count =
+            (uintptr_t)ihash_get(indegree, (uintptr_t)to) - 1;
+         ihash_put(indegree, (uintptr_t)to, (void *)count);
+
+         if (count == 0)
+            APUSH(ready, to);
+      }
+   }
+
+   // Processes on or after a loop never reach zero in-degree
+   for (int i = 0; i < ctx.procs.count; i++) {
+      rt_proc_t *p = ctx.procs.items[i];
+      if (ihash_get(indegree, (uintptr_t)p) != NULL)
+         p->level = 0;
+   }
+
+   TRACE("levelised %u of %u combinational processes into %u levels",
+         nlevelised, ctx.procs.count, maxlevel);
+
+   ACLEAR(ready);
+   ACLEAR(ctx.procs);
+   ACLEAR(ctx.edges);
+   ihash_free(indegree);
+   hash_free(ctx.leaders);
+}
+
+static void run_levelised(rt_model_t *m)
+{
+   // Zero-delay transactions from combinational processes are applied
+   // once every woken process at the same level has run so the network
+   // settles without any further delta cycles
+   for (;;) {
+      if (m->immediate.count > 0) {
+         // Any other process woken by these updates runs in the next
+         // delta cycle as usual
+         m->levelising = true;
+
+         for (int i = 0; i < m->immediate.count; i++) {
+            rt_source_t *src = m->immediate.items[i];
+            update_driver(m, src->u.driver.nexus, src);
+         }
+         ATRIM(m->immediate, 0);
+
+         workq_start(m->effq);
+         workq_drain(m->effq);
+
+         if (m->implicitq != NULL) {
+            workq_start(m->implicitq);
+            workq_drain(m->implicitq);
+         }
+
+         m->levelising = false;
+      }
+      else if (heap_size(m->levelq) > 0) {
+         const unsigned level = ((rt_proc_t *)heap_min(m->levelq))->level;
+         do {
+            rt_proc_t *proc = heap_extract_min(m->levelq);
+            assert(proc->wakeable.pending);
+            proc->wakeable.pending = false;
+
+            for (rt_proc_t *it = proc; it != NULL; it = it->fused)
+               run_process(m, it);
+         } while (heap_size(m->levelq) > 0
+                  && ((rt_proc_t *)heap_min(m->levelq))->level == level);
+      }
+      else
+         break;
+   }
+}
+
+typedef struct {
+   hset_t *targets;
+   hset_t *read;
+   bool    external;
+} read_ctx_t;
+
+static void signal_target_cb(tree_t t, void *context)
+{
+   read_ctx_t *ctx = context;
+
+   tree_t target = tree_target(t);
+   for (;;) {
+      switch (tree_kind(target)) {
+      case T_REF:
+         hset_insert(ctx->targets, target);
+         return;
+      case T_ARRAY_REF:
+      case T_ARRAY_SLICE:
+      case T_RECORD_REF:
+         target = tree_value(target);
+         break;
+      default:
+         return;
+      }
+   }
+}
+
+static void signal_read_cb(tree_t t, void *context)
+{
+   read_ctx_t *ctx = context;
+
+   if (tree_kind(t) == T_EXTERNAL_NAME)
+      ctx->external = true;
+   else if (tree_has_ref(t) && !hset_contains(ctx->targets, t))
+      hset_insert(ctx->read, tree_ref(t));
+}
+
+static void collect_reads(read_ctx_t *ctx, tree_t block)
+{
+   // Any signal associated with a port is treated as read as port
+   // collapsing may cause it to share storage with the port
+   const int nparams = tree_params(block);
+   for (int i = 0; i < nparams; i++)
+      tree_visit_only(tree_param(block, i), signal_read_cb, ctx, T_REF);
+
+   const int ndecls = tree_decls(block);
+   for (int i = 0; i < ndecls; i++) {
+      tree_t d = tree_decl(block, i);
+      tree_visit_only(d, signal_read_cb, ctx, T_REF);
+      tree_visit_only(d, signal_read_cb, ctx, T_EXTERNAL_NAME);
+   }
+
+   const int nstmts = tree_stmts(block);
+   for (int i = 0; i < nstmts; i++) {
+      tree_t s = tree_stmt(block, i);
+      if (tree_kind(s) == T_BLOCK)
+         collect_reads(ctx, s);
+      else {
+         tree_visit_only(s, signal_target_cb, ctx, T_SIGNAL_ASSIGN);
+         tree_visit_only(s, signal_read_cb, ctx, T_REF);
+         tree_visit_only(s, signal_read_cb, ctx, T_EXTERNAL_NAME);
+      }
+   }
+}
+
+static void mark_lazy_scope(rt_scope_t *s, hset_t *read)
+{
+   if (s->kind != SCOPE_INSTANCE)
+      return;
+
+   for (rt_signal_t *sig = s->signals; sig; sig = sig->chain) {
+      if (tree_kind(sig->where) != T_SIGNAL_DECL)
+         continue;
+      else if (sig->resolution != NULL)
+         continue;   // Resolution function may have side effects
+      else if (hset_contains(read, sig->where))
+         continue;
+
+      rt_nexus_t *n = &(sig->nexus);
+      for (unsigned i = 0; i < sig->n_nexus; i++, n = n->chain) {
+         const net_flags_t mask =
+            NET_F_EFFECTIVE | NET_F_INOUT | NET_F_IMPLICIT;
+         if (!(n->flags & mask) && n->outputs == NULL)
+            n->flags |= NET_F_LAZY;
+      }
+   }
+
+   for (rt_scope_t *c = s->child; c != NULL; c = c->chain)
+      mark_lazy_scope(c, read);
+}
+
+static void mark_lazy_signals(rt_model_t *m)
+{
+   // Signals which are never read by any process and do not drive any
+   // port need not have their values updated unless something starts
+   // to observe them later through a watch or the VHPI
+
+   read_ctx_t ctx = {
+      .targets = hset_new(256),
+      .read    = hset_new(256),
+   };
+
+   collect_reads(&ctx, tree_stmt(m->top, 0));
+
+   if (!ctx.external) {
+      for (rt_scope_t *c = m->root->child; c != NULL; c = c->chain)
+         mark_lazy_scope(c, ctx.read);
+   }
+
+   hset_free(ctx.targets);
+   hset_free(ctx.read);
+}
+
+void model_reset(rt_model_t *m)
+{
+   MODEL_ENTRY(m);
+
+   // Initialisation is described in LRM 93 section 12.6.4
+
+   reset_coverage(m);
+   reset_scope(m, m->root);
+
+   hash_t *moved = hash_new(256);
+   m->nets_packed = true;
+
+   for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain)
+      pack_nets(m, n, moved);
+
+   const void *key;
+   void *value;
+   for (hash_iter_t it = HASH_BEGIN;
+        hash_iter(moved, &it, &key, &value); )
+      free((void *)key);
+
+   hash_free(moved);
+
+   if (m->force_stop)
+      return;   // Error in intialisation
+
+   if (m->parallel)
+      build_partitions(m);
+
+   for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain)
+      collapse_port(n);
+
+   if (m->levelq != NULL)
+      levelise_processes(m);
+
+#if TRACE_SIGNALS > 0
+   if (__trace_on)
+      dump_signals(m, m->root);
+#endif
+
+   TRACE("calculate initial signal values");
+
+   // The signals in the model are updated as follows in an order such
+   // that if a given signal R depends upon the current value of another
+   // signal S, then the current value of S is updated prior to the
+   // updating of the current value of R.
+
+   heap_t *q = heap_new(MAX(m->n_signals + 1, 128));
+
+   for (rt_nexus_t *n = m->nexuses; n != NULL; n = n->chain) {
+      // The initial value of each driver is the default value of the signal
+      if (n->n_sources > 0) {
+         for (rt_source_t *s = &(n->sources); s; s = s->chain_input) {
+            if (s->tag == SOURCE_DRIVER)
+               copy_value_ptr(n, &(s->u.driver.value), n->resolved);
+         }
+      }
+
+      heap_insert(q, nexus_rank(n), n);
+   }
+
+   SCOPED_A(rt_nexus_t *) effq = AINIT;
+
+   while (heap_size(q) > 0) {
+      rt_nexus_t *n = heap_extract_min(q);
+
+      if (n->flags & NET_F_EFFECTIVE) {
+         // Driving and effective values must be calculated separately
+         void *driving = n->resolved + 2*n->signal->shared.size;
+         memcpy(driving, driving_value(n), n->width * n->size);
+
+         APUSH(effq, n);
+
+         TRACE("%s initial driving value %s",
+               istr(tree_ident(n->signal->where)), fmt_nexus(n, driving));
+      }
+      else {
+         // Effective value is always the same as the driving value
+         const void *initial = n->resolved;
+         if (n->n_sources > 0)
+            initial = driving_value(n);
+
+         propagate_nexus(n, initial);
+
+         TRACE("%s initial value %s", istr(tree_ident(n->signal->where)),
+               fmt_nexus(n, initial));
+      }
+   }
+
+   heap_free(q);
+
+   // Update effective values after all initial driving values calculated
+   for (int i = 0; i < effq.count; i++) {
+      rt_nexus_t *n = effq.items[i];
+
+      const void *initial = effective_value(n);
+      propagate_nexus(n, initial);
+
+      TRACE("%s initial effective value %s", istr(tree_ident(n->signal->where)),
+            fmt_nexus(n, initial));
+   }
+
+   mark_lazy_signals(m);
+}
+
+static void cancel_timeout(rt_model_t *m, rt_proc_t *proc)
+{
+   // The process resumed before its timeout expired
+   if (proc->timeout != NULL) {
+      wheel_cancel(m->eventq, proc->timeout->proc.node);
+      rt_free(m->event_stack, proc->timeout);
+      proc->timeout = NULL;
+   }
+}
+
+static void sched_event(rt_model_t *m, sens_list_t **list,
+                        rt_wakeable_t *obj, bool recur)
+{
+   // See if there is already a stale entry in the pending list for this
+   // object
+   sens_list_t *it = *list;
+   int count = 0;
+   for (; it != NULL; it = it->next, ++count) {
+      if ((it->wake == obj) && (it->wakeup_gen != obj->wakeup_gen))
+         break;
+   }
+
+   if (it == NULL) {
+      sens_list_t *node = rt_alloc(m->sens_list_stack);
+      node->wake       = obj;
+      node->wakeup_gen = obj->wakeup_gen;
+      node->next       = *list;
+      node->recur      = recur;
+
+      *list = node;
+   }
+   else {
+      // Reuse the stale entry
+      it->wakeup_gen = obj->wakeup_gen;
+   }
+}
+
+static rt_source_t *find_driver(rt_nexus_t *nexus)
+{
+   // Each process keeps a table of its drivers indexed by nexus to
+   // avoid searching the source list which may be very long for a
+   // resolved signal with many drivers
+   if (likely(active_proc != NULL)) {
+      if (active_proc->drivers == NULL)
+         return NULL;
+      else
+         return ihash_get(active_proc->drivers, (uintptr_t)nexus);
+   }
+
+   for (rt_source_t *d = &(nexus->sources); d; d = d->chain_input) {
       if (d->tag == SOURCE_DRIVER && d->u.driver.proc == active_proc)
          return d;
    }
@@ -1982,31 +4031,54 @@ static rt_source_t *find_driver(rt_nexus_t *nexus)
    return NULL;
 }
 
-static inline bool insert_transaction(rt_model_t *m, rt_nexus_t *nexus,
-                                      rt_source_t *source, waveform_t *w,
-                                      uint64_t when, uint64_t reject)
+static waveform_t *remove_transaction(rt_source_t *source, waveform_t *last,
+                                      waveform_t *it)
 {
-   waveform_t *last = &(source->u.driver.waveforms);
-   waveform_t *it   = last->next;
+   waveform_t *head = &(source->u.driver.pending);
+   if (it == head) {
+      // Move the next transaction from the overflow list inline
+      waveform_t *next = head->next;
+      if (next == NULL) {
+         source->pending = 0;
+         return NULL;
+      }
+
+      *head = *next;
+      free_waveform(next);
+      return head;
+   }
+   else {
+      waveform_t *next = it->next;
+      last->next = next;
+      free_waveform(it);
+      return next;
+   }
+}
+
+static inline bool insert_transaction(rt_model_t *m, rt_nexus_t *nexus,
+                                      rt_source_t *source, uint64_t when,
+                                      uint64_t reject, const rt_value_t *value)
+{
+   // The earliest future transaction is stored inline in the driver
+   // and only subsequent transactions are allocated from the pool
+   waveform_t *head = &(source->u.driver.pending);
+   waveform_t *last = NULL;
+   waveform_t *it   = source->pending ? head : NULL;
    while (it != NULL && it->when < when) {
       // If the current transaction is within the pulse rejection interval
       // and the value is different to that of the new transaction then
       // delete the current transaction
       assert(it->when >= m->now);
       if (it->when >= when - reject
-          && (w == NULL || !cmp_values(nexus, it->value, w->value))) {
-         waveform_t *next = it->next;
-         last->next = next;
+          && (value == NULL || !cmp_values(nexus, it->value, *value))) {
          free_value(nexus, it->value);
-         free_waveform(it);
-         it = next;
+         it = remove_transaction(source, last, it);
       }
       else {
          last = it;
          it = it->next;
       }
    }
-   last->next = w;
 
    // Delete all transactions later than this
    // We could remove this transaction from the deltaq as well but the
@@ -2017,9 +4089,28 @@ static inline bool insert_transaction(rt_model_t *m, rt_nexus_t *nexus,
       next = it->next;
       already_scheduled |= (it->when == when);
       free_value(nexus, it->value);
-      free_waveform(it);
+      if (it != head)
+         free_waveform(it);
    }
 
+   if (value != NULL) {
+      waveform_t *w;
+      if (last == NULL) {
+         w = head;
+         source->pending = 1;
+      }
+      else
+         w = (last->next = alloc_waveform());
+
+      w->when  = when;
+      w->next  = NULL;
+      w->value = *value;
+   }
+   else if (last == NULL)
+      source->pending = 0;
+   else
+      last->next = NULL;
+
    return already_scheduled;
 }
 
@@ -2029,17 +4120,16 @@ static void sched_driver(rt_model_t *m, rt_nexus_t *nexus, uint64_t after,
    rt_source_t *d = find_driver(nexus);
    assert(d != NULL);
 
-   if (unlikely(reject > after))
-      jit_msg(NULL, DIAG_FATAL, "signal %s pulse reject limit %s is greater "
-              "than delay %s", istr(tree_ident(nexus->signal->where)),
-              fmt_time(reject), fmt_time(after));
+   if (m->profile)
+      relaxed_add(&(nexus->signal->prof_transactions), 1);
 
-   waveform_t *w = alloc_waveform();
-   w->when  = m->now + after;
-   w->next  = NULL;
-   w->value = value;
+   const uint64_t when = m->now + after;
 
-   if (!insert_transaction(m, nexus, d, w, w->when, reject))
+   if (insert_transaction(m, nexus, d, when, reject, &value))
+      return;
+   else if (after == 0 && active_proc != NULL && active_proc->level > 0)
+      APUSH(m->immediate, d);   // Applied at the end of this level
+   else
       deltaq_insert_driver(m, after, nexus, d);
 }
 
@@ -2049,9 +4139,12 @@ static void sched_disconnect(rt_model_t *m, rt_nexus_t *nexus, uint64_t after,
    rt_source_t *d = find_driver(nexus);
    assert(d != NULL);
 
+   if (m->profile)
+      relaxed_add(&(nexus->signal->prof_transactions), 1);
+
    const uint64_t when = m->now + after;
 
-   insert_transaction(m, nexus, d, NULL, when, reject);
+   insert_transaction(m, nexus, d, when, reject, NULL);
    deltaq_insert_disconnect(m, after, d);
 }
 
@@ -2089,6 +4182,49 @@ static void async_update_implicit_signal(void *context, void *arg)
    update_implicit_signal(m, imp);
 }
 
+static txbuf_t *attach_worker(rt_model_t *m)
+{
+   const int tid = thread_id();
+   txbuf_t *tb = m->txbufs[tid];
+   if (tb == NULL)
+      tb = m->txbufs[tid] = xcalloc(sizeof(txbuf_t));
+
+   mspace_attach_thread(m->mspace);
+
+   if (!tlab_valid(__nvc_tlab) && tlab_valid(tb->tlab))
+      tlab_move(tb->tlab, __nvc_tlab);
+
+   return tb;
+}
+
+static void detach_worker(rt_model_t *m, txbuf_t *tb)
+{
+   // Save the TLAB where the main thread can release it
+   if (tlab_valid(__nvc_tlab) && !tlab_valid(tb->tlab))
+      tlab_move(__nvc_tlab, tb->tlab);
+
+   mspace_detach_thread(m->mspace);
+}
+
+static void run_process_parallel(rt_model_t *m, rt_proc_t *proc)
+{
+   txbuf_t *tb = attach_worker(m);
+
+   active_txbuf = tb;
+
+   if (proc->exclusive) {
+      mspace_stop_world(m->mspace);
+      run_process(m, proc);
+      mspace_start_world(m->mspace);
+   }
+   else
+      run_process(m, proc);
+
+   active_txbuf = NULL;
+
+   detach_worker(m, tb);
+}
+
 static void async_run_process(void *context, void *arg)
 {
    rt_model_t *m = context;
@@ -2098,14 +4234,20 @@ static void async_run_process(void *context, void *arg)
    proc->wakeable.pending = false;
 
    MODEL_ENTRY(m);
-   run_process(m, proc);
+
+   if (m->parallel)
+      run_process_parallel(m, proc);
+   else {
+      run_process(m, proc);
+
+      // Run any other processes with the same sensitivity
+      for (rt_proc_t *it = proc->fused; it != NULL; it = it->fused)
+         run_process(m, it);
+   }
 }
 
-static void notify_event(rt_model_t *m, rt_net_t *net)
+static void wakeup_pending(rt_model_t *m, rt_net_t *net)
 {
-   net->last_event = net->last_active = m->now;
-   net->event_delta = net->active_delta = m->iteration;
-
    // Wake up everything on the pending list
    for (sens_list_t *it = net->pending, *next, **reenq = &(net->pending);
         it; it = next) {
@@ -2122,6 +4264,10 @@ static void notify_event(rt_model_t *m, rt_net_t *net)
 
       if (!stale && !it->wake->pending) {
          workq_t *wq = it->wake->postponed ? m->postponedq : m->procq;
+         if (m->levelising && wq == m->procq) {
+            wq = m->delta_procq;
+            m->next_is_delta = true;
+         }
 
          switch (it->wake->kind) {
          case W_PROC:
@@ -2129,7 +4275,11 @@ static void notify_event(rt_model_t *m, rt_net_t *net)
                rt_proc_t *proc = container_of(it->wake, rt_proc_t, wakeable);
                TRACE("wakeup %sprocess %s",
                      it->wake->postponed ? "postponed " : "", istr(proc->name));
-               workq_do(wq, async_run_process, proc);
+               if (proc->level > 0)
+                  heap_insert(m->levelq, proc->level, proc);
+               else
+                  workq_do(wq, async_run_process, proc);
+               cancel_timeout(m, proc);
             }
             break;
 
@@ -2149,6 +4299,10 @@ static void notify_event(rt_model_t *m, rt_net_t *net)
                rt_watch_t *w = container_of(it->wake, rt_watch_t, wakeable);
                TRACE("wakeup implicit signal %s",
                      istr(tree_ident(w->signal->where)));
+
+               if (m->parallel && wq == m->procq)
+                  wq = m->watchq;   // Callbacks must run on the main thread
+
                workq_do(wq, async_watch_callback, w);
             }
             break;
@@ -2169,6 +4323,22 @@ static void notify_event(rt_model_t *m, rt_net_t *net)
    }
 }
 
+static void notify_event(rt_model_t *m, rt_nexus_t *nexus, rt_net_t *net)
+{
+   if (m->profile)
+      relaxed_add(&(nexus->signal->prof_events), 1);
+
+   net->last_event = net->last_active = m->now;
+   net->event_delta = net->active_delta = m->iteration;
+
+   if (net->pending == NULL)
+      return;
+   else if (active_partition != NULL)
+      APUSH(active_partition->events, net);   // Woken on main thread
+   else
+      wakeup_pending(m, net);
+}
+
 static void notify_active(rt_model_t *m, rt_net_t *net)
 {
    net->last_active = m->now;
@@ -2186,7 +4356,7 @@ static void update_effective(rt_model_t *m, rt_nexus_t *nexus)
 
    if (memcmp(nexus->resolved, value, nexus->size * nexus->width) != 0) {
       propagate_nexus(nexus, value);
-      notify_event(m, net);
+      notify_event(m, nexus, net);
    }
    else
       notify_active(m, net);
@@ -2203,7 +4373,12 @@ static void async_update_effective(void *context, void *arg)
 
 static void enqueue_effective(rt_model_t *m, rt_nexus_t *nexus)
 {
-   workq_do(m->effq, async_update_effective, nexus);
+   if (active_partition != NULL) {
+      assert(nexus->partition == active_partition);
+      APUSH(active_partition->effq, nexus);
+   }
+   else
+      workq_do(m->effq, async_update_effective, nexus);
 
    if (nexus->n_sources > 0) {
       for (rt_source_t *s = &(nexus->sources); s; s = s->chain_input) {
@@ -2213,43 +4388,68 @@ static void enqueue_effective(rt_model_t *m, rt_nexus_t *nexus)
    }
 }
 
-static void update_driving(rt_model_t *m, rt_nexus_t *nexus)
+static void update_driving(rt_model_t *m, rt_nexus_t *nexus);
+
+static inline bool is_unobserved(rt_nexus_t *nexus)
 {
-   const void *value = driving_value(nexus);
+   return (nexus->flags & NET_F_LAZY)
+      && (nexus->net == NULL || nexus->net->pending == NULL);
+}
+
+static void propagate_driving(rt_model_t *m, rt_nexus_t *nexus,
+                              const void *value)
+{
+   if (unlikely(is_unobserved(nexus))) {
+      nexus->flags |= NET_F_STALE;
+      return;
+   }
+
    const size_t valuesz = nexus->size * nexus->width;
 
    TRACE("update %s driving value %s", istr(tree_ident(nexus->signal->where)),
          fmt_nexus(nexus, value));
 
    rt_net_t *net = get_net(m, nexus);
-   bool update_outputs = false;
+   void *driving = NULL;
 
    if (nexus->flags & NET_F_EFFECTIVE) {
       // The active and event flags will be set when we update the
       // effective value later
-      update_outputs = true;
-
-      void *driving = nexus->resolved + 2*nexus->signal->shared.size;
+      driving = nexus->resolved + 2*nexus->signal->shared.size;
       memcpy(driving, value, valuesz);
 
       enqueue_effective(m, nexus);
    }
    else if (memcmp(nexus->resolved, value, valuesz) != 0) {
       propagate_nexus(nexus, value);
-      notify_event(m, net);
-      update_outputs = true;
+      notify_event(m, nexus, net);
+      driving = nexus->resolved;
    }
    else
       notify_active(m, net);
 
-   if (update_outputs) {
-      for (rt_source_t *o = nexus->outputs; o; o = o->chain_output) {
+   if (driving != NULL) {
+      for (rt_source_t *o = nexus->outputs; o; o = o->u.port.chain_output) {
          assert(o->tag == SOURCE_PORT);
-         update_driving(m, o->u.port.output);
+
+         rt_nexus_t *out = o->u.port.output;
+         const net_flags_t mask = NET_F_COLLAPSED | NET_F_FORCED;
+         if ((out->flags & mask) == NET_F_COLLAPSED)
+            propagate_driving(m, out, driving);
+         else
+            update_driving(m, out);
       }
    }
 }
 
+static void update_driving(rt_model_t *m, rt_nexus_t *nexus)
+{
+   if (unlikely(is_unobserved(nexus)))
+      nexus->flags |= NET_F_STALE;   // Resolved when next read
+   else
+      propagate_driving(m, nexus, driving_value(nexus));
+}
+
 static void update_driver(rt_model_t *m, rt_nexus_t *nexus, rt_source_t *source)
 {
    // Updating drivers may involve calling resolution functions
@@ -2257,18 +4457,15 @@ static void update_driver(rt_model_t *m, rt_nexus_t *nexus, rt_source_t *source)
       tlab_acquire(m->mspace, &__nvc_tlab);
 
    if (likely(source != NULL)) {
-      waveform_t *w_now  = &(source->u.driver.waveforms);
-      waveform_t *w_next = w_now->next;
+      waveform_t *head = &(source->u.driver.pending);
 
-      if (likely((w_next != NULL) && (w_next->when == m->now))) {
-         free_value(nexus, w_now->value);
-         *w_now = *w_next;
-         free_waveform(w_next);
+      if (likely(source->pending && head->when == m->now)) {
+         free_value(nexus, source->u.driver.value);
+         source->u.driver.value = head->value;
+         remove_transaction(source, NULL, head);
          source->disconnected = 0;
          update_driving(m, nexus);
       }
-      else
-         assert(w_now != NULL);
    }
    else  // Update due to force/release
       update_driving(m, nexus);
@@ -2276,11 +4473,91 @@ static void update_driver(rt_model_t *m, rt_nexus_t *nexus, rt_source_t *source)
    tlab_reset(__nvc_tlab);   // No allocations can be live past here
 }
 
+static bool defer_to_partition(rt_model_t *m, rt_nexus_t *nexus,
+                               task_fn_t fn, void *arg)
+{
+   rt_partition_t *p = nexus->partition;
+   if (!m->parallel || p == NULL || active_partition != NULL)
+      return false;
+
+   if (p->tasks.count == 0) {
+      workq_do(m->partq, async_update_partition, p);
+      APUSH(m->active_parts, p);
+   }
+
+   APUSH(p->tasks, ((part_task_t){ fn, arg }));
+   return true;
+}
+
+static void async_update_partition(void *context, void *arg)
+{
+   rt_model_t *m = context;
+   rt_partition_t *p = arg;
+
+   MODEL_ENTRY(m);
+
+   txbuf_t *tb = attach_worker(m);
+
+   // Collect the waveforms freed by this partition separately so they
+   // can be returned to the main thread which allocates them
+   waveform_t *saved = free_waveforms;
+   free_waveforms = NULL;
+
+   active_partition = p;
+
+   for (int i = 0; i < p->tasks.count; i++)
+      (*p->tasks.items[i].fn)(m, p->tasks.items[i].arg);
+
+   // Ports in this partition only have effective values that depend on
+   // other nexuses in the same partition
+   for (int i = 0; i < p->effq.count; i++)
+      update_effective(m, p->effq.items[i]);
+
+   active_partition = NULL;
+
+   p->freed = free_waveforms;
+   free_waveforms = saved;
+
+   ATRIM(p->tasks, 0);
+   ATRIM(p->effq, 0);
+
+   detach_worker(m, tb);
+}
+
+static void update_partitions(rt_model_t *m)
+{
+   workq_start(m->partq);
+   workq_drain(m->partq);
+
+   // Processes are woken up in a deterministic order regardless of
+   // which thread updated each partition
+   for (int i = 0; i < m->active_parts.count; i++) {
+      rt_partition_t *p = m->active_parts.items[i];
+
+      for (int j = 0; j < p->events.count; j++)
+         wakeup_pending(m, p->events.items[j]);
+
+      ATRIM(p->events, 0);
+
+      for (waveform_t *w = p->freed, *next; w; w = next) {
+         next = w->next;
+         free_waveform(w);
+      }
+
+      p->freed = NULL;
+   }
+
+   ATRIM(m->active_parts, 0);
+}
+
 static void async_update_driver(void *context, void *arg)
 {
    rt_model_t *m = context;
    rt_source_t *src = arg;
 
+   if (defer_to_partition(m, src->u.driver.nexus, async_update_driver, src))
+      return;
+
    MODEL_ENTRY(m);
    update_driver(m, src->u.driver.nexus, src);
 }
@@ -2290,6 +4567,9 @@ static void async_disconnect(void *context, void *arg)
    rt_model_t *m = context;
    rt_source_t *src = arg;
 
+   if (defer_to_partition(m, src->u.driver.nexus, async_disconnect, src))
+      return;
+
    MODEL_ENTRY(m);
    src->disconnected = 1;
    update_driver(m, src->u.driver.nexus, NULL);
@@ -2300,6 +4580,9 @@ static void async_update_driving(void *context, void *arg)
    rt_model_t *m = context;
    rt_nexus_t *nexus = arg;
 
+   if (defer_to_partition(m, nexus, async_update_driving, nexus))
+      return;
+
    MODEL_ENTRY(m);
    update_driver(m, nexus, NULL);
 }
@@ -2309,7 +4592,7 @@ static void update_implicit_signal(rt_model_t *m, rt_implicit_t *imp)
    jit_scalar_t result;
    if (!jit_try_call(m->jit, imp->closure.handle, &result,
                      imp->closure.context))
-      m->force_stop = true;
+      relaxed_store(&m->force_stop, true);
 
    TRACE("implicit signal %s guard expression %"PRIi64,
          istr(tree_ident(imp->signal.where)), result.integer);
@@ -2321,7 +4604,7 @@ static void update_implicit_signal(rt_model_t *m, rt_implicit_t *imp)
 
    if (*(int8_t *)n0->resolved != result.integer) {
       propagate_nexus(n0, &result.integer);
-      notify_event(m, net);
+      notify_event(m, n0, net);
    }
    else
       notify_active(m, net);
@@ -2364,6 +4647,177 @@ static void reached_iteration_limit(rt_model_t *m)
    jit_abort(EXIT_FAILURE);
 }
 
+static void sched_waveform_s(rt_model_t *m, rt_signal_t *s, uint32_t offset,
+                             uint64_t scalar, int64_t after, int64_t reject)
+{
+   rt_nexus_t *n = split_nexus(m, s, offset, 1);
+
+   rt_value_t value = alloc_value(m, n);
+   value.qword = scalar;
+
+   sched_driver(m, n, after, reject, value);
+}
+
+static void sched_waveform(rt_model_t *m, rt_signal_t *s, uint32_t offset,
+                           const void *values, int32_t count, int64_t after,
+                           int64_t reject)
+{
+   rt_nexus_t *n = split_nexus(m, s, offset, count);
+   const char *vptr = values;
+   for (; count > 0; n = n->chain) {
+      count -= n->width;
+      assert(count >= 0);
+
+      const size_t valuesz = n->width * n->size;
+      rt_value_t value = alloc_value(m, n);
+      copy_value_ptr(n, &value, vptr);
+      vptr += valuesz;
+
+      sched_driver(m, n, after, reject, value);
+   }
+}
+
+static void sched_signal_event(rt_model_t *m, rt_signal_t *s, uint32_t offset,
+                               int32_t count, rt_wakeable_t *wake, bool recur)
+{
+   rt_nexus_t *n = split_nexus(m, s, offset, count);
+   for (; count > 0; n = n->chain) {
+      if (unlikely(n->flags & NET_F_STALE))
+         refresh_nexus(m, n);
+
+      sched_event(m, &(get_net(m, n)->pending), wake, recur);
+
+      count -= n->width;
+      assert(count >= 0);
+   }
+}
+
+static void disconnect_signal(rt_model_t *m, rt_signal_t *s, uint32_t offset,
+                              int32_t count, int64_t after, int64_t reject)
+{
+   rt_nexus_t *n = split_nexus(m, s, offset, count);
+   for (; count > 0; n = n->chain) {
+      count -= n->width;
+      assert(count >= 0);
+
+      sched_disconnect(m, n, after, reject);
+   }
+}
+
+static void sched_force(rt_model_t *m, rt_signal_t *s, uint32_t offset,
+                        int32_t count, const void *values)
+{
+   rt_nexus_t *n = split_nexus(m, s, offset, count);
+   const char *vptr = values;
+   for (; count > 0; n = n->chain) {
+      count -= n->width;
+      assert(count >= 0);
+
+      if (!(n->flags & NET_F_FORCED)) {
+         n->flags |= NET_F_FORCED;
+         n->forcing = alloc_value(m, n);
+      }
+
+      copy_value_ptr(n, &(n->forcing), vptr);
+      vptr += n->width * n->size;
+
+      deltaq_insert_force_release(m, 0, n);
+   }
+}
+
+static void sched_release(rt_model_t *m, rt_signal_t *s, uint32_t offset,
+                          int32_t count)
+{
+   rt_nexus_t *n = split_nexus(m, s, offset, count);
+   for (; count > 0; n = n->chain) {
+      count -= n->width;
+      assert(count >= 0);
+
+      if (n->flags & NET_F_FORCED) {
+         n->flags &= ~NET_F_FORCED;
+         free_value(n, n->forcing);
+         n->forcing.qword = 0;
+      }
+
+      deltaq_insert_force_release(m, 0, n);
+   }
+}
+
+static tx_record_t *defer_signal_op(tx_kind_t kind, rt_signal_t *s,
+                                    uint32_t offset, int32_t count,
+                                    size_t valuesz)
+{
+   txbuf_t *tb = active_txbuf;
+   assert(tb != NULL);
+
+   const size_t recsz = ALIGN_UP(sizeof(tx_record_t) + valuesz, 8);
+   if (tb->used + recsz > tb->size) {
+      tb->size = MAX(tb->size * 2, MAX(tb->used + recsz, 4096));
+      tb->data = xrealloc(tb->data, tb->size);
+   }
+
+   tx_record_t *rec = (tx_record_t *)(tb->data + tb->used);
+   rec->kind    = kind;
+   rec->offset  = offset;
+   rec->count   = count;
+   rec->valuesz = valuesz;
+   rec->proc    = active_proc;
+   rec->signal  = s;
+
+   tb->used += recsz;
+   return rec;
+}
+
+static void flush_transactions(rt_model_t *m)
+{
+   // Replay the signal operations from processes which ran in parallel
+   // in the order each thread executed them
+   for (int i = 0; i < MAX_THREADS; i++) {
+      txbuf_t *tb = m->txbufs[i];
+      if (tb == NULL)
+         continue;
+
+      for (size_t pos = 0; pos < tb->used; ) {
+         tx_record_t *rec = (tx_record_t *)(tb->data + pos);
+         pos += ALIGN_UP(sizeof(tx_record_t) + rec->valuesz, 8);
+
+         active_proc = rec->proc;
+
+         switch (rec->kind) {
+         case TX_WAVEFORM:
+            sched_waveform(m, rec->signal, rec->offset, rec->values,
+                           rec->count, rec->after, rec->reject);
+            break;
+         case TX_WAVEFORM_S:
+            sched_waveform_s(m, rec->signal, rec->offset, rec->values[0],
+                             rec->after, rec->reject);
+            break;
+         case TX_EVENT:
+            sched_signal_event(m, rec->signal, rec->offset, rec->count,
+                               rec->wake, rec->recur);
+            break;
+         case TX_PROCESS:
+            deltaq_insert_proc(m, rec->after, rec->proc);
+            break;
+         case TX_DISCONNECT:
+            disconnect_signal(m, rec->signal, rec->offset, rec->count,
+                              rec->after, rec->reject);
+            break;
+         case TX_FORCE:
+            sched_force(m, rec->signal, rec->offset, rec->count, rec->values);
+            break;
+         case TX_RELEASE:
+            sched_release(m, rec->signal, rec->offset, rec->count);
+            break;
+         }
+      }
+
+      tb->used = 0;
+   }
+
+   active_proc = NULL;
+}
+
 static void swap_workq(workq_t **a, workq_t **b)
 {
    workq_t *tmp = *a;
@@ -2378,19 +4832,20 @@ static void model_cycle(rt_model_t *m)
    const bool is_delta_cycle = m->next_is_delta;
    m->next_is_delta = false;
 
+   void **batch = NULL;
+   size_t nbatch = 0;
+
    if (is_delta_cycle)
       m->iteration = m->iteration + 1;
    else {
-      event_t *peek = heap_min(m->eventq_heap);
-      while (unlikely(is_stale_event(peek))) {
-         // Discard stale events
-         rt_free(m->event_stack, heap_extract_min(m->eventq_heap));
-         if (heap_size(m->eventq_heap) == 0)
-            return;
-         else
-            peek = heap_min(m->eventq_heap);
-      }
-      m->now = peek->when;
+      uint64_t when;
+      if ((nbatch = wheel_pop(m->eventq, &when, &batch)) == 0)
+         return;
+
+      if (m->profile)
+         profile_time_step(m);
+
+      m->now = when;
       m->iteration = 0;
    }
 
@@ -2408,43 +4863,48 @@ static void model_cycle(rt_model_t *m)
       global_event(m, RT_NEXT_TIME_STEP);
 
       for (;;) {
-         event_t *e = heap_extract_min(m->eventq_heap);
-         switch (e->kind) {
-         case EVENT_PROCESS:
-            if (!is_stale_event(e)) {
+         for (size_t i = 0; i < nbatch; i++) {
+            event_t *e = batch[i];
+            switch (e->kind) {
+            case EVENT_PROCESS:
                assert(!e->proc.proc->wakeable.pending);
+               assert(e->proc.proc->timeout == e);
                workq_do(m->procq, async_run_process, e->proc.proc);
                e->proc.proc->wakeable.pending = true;
+               e->proc.proc->timeout = NULL;
                ++(e->proc.proc->wakeable.wakeup_gen);
+               rt_free(m->event_stack, e);
+               break;
+            case EVENT_DRIVER:
+               workq_do(m->driverq, async_update_driver, e->driver.source);
+               rt_free(m->event_stack, e);
+               break;
+            case EVENT_TIMEOUT:
+               workq_do(m->driverq, async_timeout_callback, e);
+               // Event freed in callback
+               break;
+            case EVENT_DISCONNECT:
+               workq_do(m->driverq, async_disconnect, e->driver.source);
+               rt_free(m->event_stack, e);
+               break;
             }
-            rt_free(m->event_stack, e);
-            break;
-         case EVENT_DRIVER:
-            workq_do(m->driverq, async_update_driver, e->driver.source);
-            rt_free(m->event_stack, e);
-            break;
-         case EVENT_TIMEOUT:
-            workq_do(m->driverq, async_timeout_callback, e);
-            // Event freed in callback
-            break;
-         case EVENT_DISCONNECT:
-            workq_do(m->driverq, async_disconnect, e->driver.source);
-            rt_free(m->event_stack, e);
-            break;
          }
 
-         if (heap_size(m->eventq_heap) == 0)
+         // Callbacks may have scheduled more events for this time step
+         uint64_t next;
+         if (!wheel_peek(m->eventq, &next) || next > m->now)
             break;
 
-         event_t *peek = heap_min(m->eventq_heap);
-         if (peek->when > m->now)
-            break;
+         nbatch = wheel_pop(m->eventq, &next, &batch);
       }
    }
 
    workq_start(m->driverq);
    workq_drain(m->driverq);
 
+   if (m->parallel)
+      update_partitions(m);
+
    workq_start(m->effq);
    workq_drain(m->effq);
 
@@ -2463,6 +4923,16 @@ static void model_cycle(rt_model_t *m)
    workq_start(m->procq);
    workq_drain(m->procq);
 
+   if (m->levelq != NULL)
+      run_levelised(m);
+
+   if (m->parallel) {
+      flush_transactions(m);
+
+      workq_start(m->watchq);
+      workq_drain(m->watchq);
+   }
+
    global_event(m, RT_END_OF_PROCESSES);
 
    if (!m->next_is_delta) {
@@ -2473,6 +4943,9 @@ static void model_cycle(rt_model_t *m)
       workq_start(m->postponedq);
       workq_drain(m->postponedq);
 
+      if (m->parallel)
+         flush_transactions(m);
+
       m->can_create_delta = true;
    }
    else if (m->stop_delta > 0 && m->iteration == m->stop_delta)
@@ -2485,12 +4958,67 @@ static bool should_stop_now(rt_model_t *m, uint64_t stop_time)
       return true;
    else if (m->next_is_delta)
       return false;
-   else if (heap_size(m->eventq_heap) == 0)
-      return true;
    else {
-      event_t *peek = heap_min(m->eventq_heap);
-      return peek->when > stop_time;
+      uint64_t next;
+      return !wheel_peek(m->eventq, &next) || next > stop_time;
+   }
+}
+
+static bool fork_children(rt_model_t *m)
+{
+   // Each child process continues the simulation from the current
+   // state which is shared copy-on-write with the parent
+#ifdef __MINGW32__
+   fatal("forking the simulation is not supported on Windows");
+#else
+   TRACE("fork %u children at %s", m->fork_count, fmt_time(m->now));
+
+   fflush(NULL);   // Avoid duplicating buffered output in each child
+
+   pid_t *pids = xmalloc_array(m->fork_count, sizeof(pid_t));
+   for (int i = 0; i < m->fork_count; i++) {
+      const pid_t pid = fork();
+      if (pid == 0) {
+         char buf[16];
+         checked_sprintf(buf, sizeof(buf), "%d", i);
+         setenv("NVC_FORK_INDEX", buf, 1);
+
+         m->fork_index = i;
+
+         free(pids);
+         return true;
+      }
+      else if (pid < 0)
+         fatal_errno("fork");
+
+      pids[i] = pid;
+   }
+
+   // The parent waits for all the children to complete and fails if
+   // any of them failed
+   int rc = 0;
+   for (int i = 0; i < m->fork_count; i++) {
+      int status;
+      if (waitpid(pids[i], &status, 0) != pids[i])
+         fatal_errno("waitpid");
+
+      if (WIFSIGNALED(status)) {
+         errorf("fork %d terminated by signal %d", i, WTERMSIG(status));
+         rc = rc ?: 1;
+      }
+      else if (WEXITSTATUS(status) != 0) {
+         errorf("fork %d failed with status %d", i, WEXITSTATUS(status));
+         rc = rc ?: WEXITSTATUS(status);
+      }
    }
+
+   free(pids);
+
+   if (rc != 0)
+      jit_set_exit_status(m->jit, rc);
+
+   return false;
+#endif
 }
 
 void model_run(rt_model_t *m, uint64_t stop_time)
@@ -2500,10 +5028,21 @@ void model_run(rt_model_t *m, uint64_t stop_time)
    if (m->force_stop)
       return;   // Was error during intialisation
 
-   stop_workers();   // Runtime is not thread-safe
+   if (!m->parallel)
+      stop_workers();   // Runtime is not thread-safe
 
    global_event(m, RT_START_OF_SIMULATION);
 
+   if (m->fork_count > 0 && m->fork_time <= stop_time) {
+      while (!should_stop_now(m, m->fork_time))
+         model_cycle(m);
+
+      if (!m->force_stop && !fork_children(m)) {
+         m->force_stop = true;   // Parent does not continue simulating
+         return;
+      }
+   }
+
    while (!should_stop_now(m, stop_time))
       model_cycle(m);
 
@@ -2519,6 +5058,15 @@ static inline void check_postponed(int64_t after)
             istr(active_proc->name));
 }
 
+static inline void check_reject_limit(rt_signal_t *s, uint64_t after,
+                                      uint64_t reject)
+{
+   if (unlikely(reject > after))
+      jit_msg(NULL, DIAG_FATAL, "signal %s pulse reject limit %s is greater "
+              "than delay %s", istr(tree_ident(s->where)),
+              fmt_time(reject), fmt_time(after));
+}
+
 bool force_signal(rt_signal_t *s, const uint64_t *buf, size_t count)
 {
    TRACE("force signal %s to %"PRIu64"%s",
@@ -2568,7 +5116,13 @@ int64_t model_now(rt_model_t *m, unsigned *deltas)
 
 void model_stop(rt_model_t *m)
 {
-   m->force_stop = true;
+   relaxed_store(&m->force_stop, true);
+}
+
+void model_set_fork(rt_model_t *m, uint64_t when, unsigned count)
+{
+   m->fork_time  = when;
+   m->fork_count = count;
 }
 
 void model_set_global_cb(rt_model_t *m, rt_event_t event, rt_event_fn_t fn,
@@ -2594,7 +5148,7 @@ void model_set_timeout_cb(rt_model_t *m, uint64_t when, timeout_fn_t fn,
    e->timeout.user = user;
 
    assert(when > m->now);   // TODO: delta timeouts?
-   heap_insert(m->eventq_heap, e->when, e);
+   wheel_insert(m->eventq, e->when, e);
 }
 
 rt_watch_t *model_set_event_cb(rt_model_t *m, rt_signal_t *s, sig_event_fn_t fn,
@@ -2626,9 +5180,16 @@ rt_watch_t *model_set_event_cb(rt_model_t *m, rt_signal_t *s, sig_event_fn_t fn,
       m->watches = w;
 
       rt_nexus_t *n = &(w->signal->nexus);
-      for (int i = 0; i < s->n_nexus; i++, n = n->chain)
+      for (int i = 0; i < s->n_nexus; i++, n = n->chain) {
+         if (unlikely(n->flags & NET_F_STALE))
+            refresh_nexus(m, n);
+
          sched_event(m, &(get_net(m, n)->pending), &(w->wakeable), true);
 
+         if (m->levelq != NULL)
+            delevelise_nexus(n);
+      }
+
       return w;
    }
 }
@@ -2692,16 +5253,12 @@ void x_drive_signal(sig_shared_t *ss, uint32_t offset, int32_t count)
    rt_model_t *m = get_model();
    rt_nexus_t *n = split_nexus(m, s, offset, count);
    for (; count > 0; n = n->chain) {
-      rt_source_t *s;
-      for (s = &(n->sources); s; s = s->chain_input) {
-         if (s->tag == SOURCE_DRIVER && s->u.driver.proc == active_proc)
-            break;
-      }
-
+      rt_source_t *s = find_driver(n);
       if (s == NULL) {
          s = add_source(m, n, SOURCE_DRIVER);
-         s->u.driver.waveforms.value = alloc_value(m, n);
+         s->u.driver.value = alloc_value(m, n);
          s->u.driver.proc = active_proc;
+         add_driver(active_proc, n, s);
       }
 
       count -= n->width;
@@ -2722,7 +5279,13 @@ int x_current_delta(void)
 void x_sched_process(int64_t delay)
 {
    TRACE("_sched_process delay=%s", fmt_time(delay));
-   deltaq_insert_proc(get_model(), delay, active_proc);
+
+   if (active_txbuf != NULL) {
+      tx_record_t *rec = defer_signal_op(TX_PROCESS, NULL, 0, 0, 0);
+      rec->after = delay;
+   }
+   else if (!active_proc->follower)   // Initial run is with the group
+      deltaq_insert_proc(get_model(), delay, active_proc);
 }
 
 void x_sched_waveform_s(sig_shared_t *ss, uint32_t offset, uint64_t scalar,
@@ -2735,14 +5298,17 @@ void x_sched_waveform_s(sig_shared_t *ss, uint32_t offset, uint64_t scalar,
          fmt_time(reject));
 
    check_postponed(after);
-
-   rt_model_t *m = get_model();
-   rt_nexus_t *n = split_nexus(m, s, offset, 1);
-
-   rt_value_t value = alloc_value(m, n);
-   value.qword = scalar;
-
-   sched_driver(m, n, after, reject, value);
+   check_reject_limit(s, after, reject);
+
+   if (active_txbuf != NULL) {
+      tx_record_t *rec =
+         defer_signal_op(TX_WAVEFORM_S, s, offset, 1, sizeof(uint64_t));
+      rec->after     = after;
+      rec->reject    = reject;
+      rec->values[0] = scalar;
+   }
+   else
+      sched_waveform_s(get_model(), s, offset, scalar, after, reject);
 }
 
 void x_sched_waveform(sig_shared_t *ss, uint32_t offset, void *values,
@@ -2755,21 +5321,18 @@ void x_sched_waveform(sig_shared_t *ss, uint32_t offset, void *values,
          count, fmt_time(after), fmt_time(reject));
 
    check_postponed(after);
-
-   rt_model_t *m = get_model();
-   rt_nexus_t *n = split_nexus(m, s, offset, count);
-   char *vptr = values;
-   for (; count > 0; n = n->chain) {
-      count -= n->width;
-      assert(count >= 0);
-
-      const size_t valuesz = n->width * n->size;
-      rt_value_t value = alloc_value(m, n);
-      copy_value_ptr(n, &value, vptr);
-      vptr += valuesz;
-
-      sched_driver(m, n, after, reject, value);
+   check_reject_limit(s, after, reject);
+
+   if (active_txbuf != NULL) {
+      const size_t valuesz = count * s->nexus.size;
+      tx_record_t *rec =
+         defer_signal_op(TX_WAVEFORM, s, offset, count, valuesz);
+      rec->after  = after;
+      rec->reject = reject;
+      memcpy(rec->values, values, valuesz);
    }
+   else
+      sched_waveform(get_model(), s, offset, values, count, after, reject);
 }
 
 int32_t x_test_net_event(sig_shared_t *ss, uint32_t offset, int32_t count)
@@ -2826,17 +5389,20 @@ void x_sched_event(sig_shared_t *ss, uint32_t offset, int32_t count, bool recur,
    rt_wakeable_t *wake;
    if (wake_ss != NULL)
       wake = &(container_of(wake_ss, rt_implicit_t, signal.shared)->wakeable);
+   else if (active_proc->follower) {
+      assert(recur);
+      return;   // Resumed along with the first process in the group
+   }
    else
       wake = &(active_proc->wakeable);
 
-   rt_model_t *m = get_model();
-   rt_nexus_t *n = split_nexus(m, s, offset, count);
-   for (; count > 0; n = n->chain) {
-      sched_event(m, &(get_net(m, n)->pending), wake, recur);
-
-      count -= n->width;
-      assert(count >= 0);
+   if (active_txbuf != NULL) {
+      tx_record_t *rec = defer_signal_op(TX_EVENT, s, offset, count, 0);
+      rec->wake  = wake;
+      rec->recur = recur;
    }
+   else
+      sched_signal_event(get_model(), s, offset, count, wake, recur);
 }
 
 void x_alias_signal(sig_shared_t *ss, tree_t where)
@@ -2926,6 +5492,8 @@ void x_map_signal(sig_shared_t *src_ss, uint32_t src_offset,
 
    assert(src_count == dst_count || closure != NULL);
 
+   rt_model_t *m = get_model();
+
    rt_conv_func_t *conv_func = NULL;
    if (closure != NULL) {
       size_t bufsz = dst_s->shared.size;
@@ -2936,15 +5504,31 @@ void x_map_signal(sig_shared_t *src_ss, uint32_t src_offset,
          bufsz = root->size;
       }
 
+      size_t insz = src_s->shared.size;
+      if (src_s->parent->kind == SCOPE_SIGNAL) {
+         rt_scope_t *root = src_s->parent;
+         while (root->parent->kind == SCOPE_SIGNAL)
+            root = root->parent;
+         insz = root->size;
+      }
+
       TRACE("need %zu bytes for conversion function buffer", bufsz);
 
-      conv_func = xmalloc_flex(sizeof(rt_conv_func_t), 1, bufsz);
+      conv_func = xmalloc_flex(sizeof(rt_conv_func_t), 1, bufsz + insz);
       conv_func->closure = *closure;
       conv_func->refcnt  = 0;
+      conv_func->valid   = false;
       conv_func->bufsz   = bufsz;
-   }
+      conv_func->insz    = insz;
+      conv_func->lastin  = conv_func->buffer + bufsz;
+      conv_func->memo    = NULL;
+      conv_func->nlits   = 0;
 
-   rt_model_t *m = get_model();
+      conv_func->cacheable = conversion_is_silent(active_scope, src_s, dst_s);
+
+      if (conv_func->cacheable && src_s->parent->kind != SCOPE_SIGNAL)
+         memo_conversion_fn(m, conv_func, tree_type(src_s->where));
+   }
 
    rt_nexus_t *src_n = split_nexus(m, src_s, src_offset, src_count);
    rt_nexus_t *dst_n = split_nexus(m, dst_s, dst_offset, dst_count);
@@ -2985,7 +5569,7 @@ void x_map_signal(sig_shared_t *src_ss, uint32_t src_offset,
          dst_n->flags |= NET_F_EFFECTIVE;
       }
 
-      port->chain_output = src_n->outputs;
+      port->u.port.chain_output = src_n->outputs;
       src_n->outputs = port;
 
       src_count -= src_n->width;
@@ -3119,7 +5703,7 @@ void *x_driving_value(sig_shared_t *ss, uint32_t offset, int32_t count)
          jit_msg(NULL, DIAG_FATAL, "process %s does not contain a driver "
                  "for %s", istr(active_proc->name), istr(tree_ident(s->where)));
 
-      memcpy(p, value_ptr(n, &(src->u.driver.waveforms.value)),
+      memcpy(p, value_ptr(n, &(src->u.driver.value)),
              n->width * n->size);
       p += n->width * n->size;
 
@@ -3138,8 +5722,10 @@ sig_shared_t *x_implicit_signal(uint32_t count, uint32_t size, tree_t where,
 
    rt_model_t *m = get_model();
 
-   if (m->implicitq == NULL)
+   if (m->implicitq == NULL) {
       m->implicitq = workq_new(m);
+      workq_not_thread_safe(m->implicitq);
+   }
 
    const size_t datasz = MAX(2 * count * size, 8);
    rt_implicit_t *imp = xcalloc_flex(sizeof(rt_implicit_t), 1, datasz);
@@ -3170,14 +5756,14 @@ void x_disconnect(sig_shared_t *ss, uint32_t offset, int32_t count,
 
    check_postponed(after);
 
-   rt_model_t *m = get_model();
-   rt_nexus_t *n = split_nexus(m, s, offset, count);
-   for (; count > 0; n = n->chain) {
-      count -= n->width;
-      assert(count >= 0);
-
-      sched_disconnect(m, n, after, reject);
+   if (active_txbuf != NULL) {
+      tx_record_t *rec =
+         defer_signal_op(TX_DISCONNECT, s, offset, count, 0);
+      rec->after  = after;
+      rec->reject = reject;
    }
+   else
+      disconnect_signal(get_model(), s, offset, count, after, reject);
 }
 
 void x_force(sig_shared_t *ss, uint32_t offset, int32_t count, void *values)
@@ -3189,23 +5775,13 @@ void x_force(sig_shared_t *ss, uint32_t offset, int32_t count, void *values)
 
    check_postponed(0);
 
-   rt_model_t *m = get_model();
-   rt_nexus_t *n = split_nexus(m, s, offset, count);
-   char *vptr = values;
-   for (; count > 0; n = n->chain) {
-      count -= n->width;
-      assert(count >= 0);
-
-      if (!(n->flags & NET_F_FORCED)) {
-         n->flags |= NET_F_FORCED;
-         n->forcing = alloc_value(m, n);
-      }
-
-      copy_value_ptr(n, &(n->forcing), vptr);
-      vptr += n->width * n->size;
-
-      deltaq_insert_force_release(m, 0, n);
+   if (active_txbuf != NULL) {
+      const size_t valuesz = count * s->nexus.size;
+      tx_record_t *rec = defer_signal_op(TX_FORCE, s, offset, count, valuesz);
+      memcpy(rec->values, values, valuesz);
    }
+   else
+      sched_force(get_model(), s, offset, count, values);
 }
 
 void x_release(sig_shared_t *ss, uint32_t offset, int32_t count)
@@ -3217,20 +5793,10 @@ void x_release(sig_shared_t *ss, uint32_t offset, int32_t count)
 
    check_postponed(0);
 
-   rt_model_t *m = get_model();
-   rt_nexus_t *n = split_nexus(m, s, offset, count);
-   for (; count > 0; n = n->chain) {
-      count -= n->width;
-      assert(count >= 0);
-
-      if (n->flags & NET_F_FORCED) {
-         n->flags &= ~NET_F_FORCED;
-         free_value(n, n->forcing);
-         n->forcing.qword = 0;
-      }
-
-      deltaq_insert_force_release(m, 0, n);
-   }
+   if (active_txbuf != NULL)
+      defer_signal_op(TX_RELEASE, s, offset, count, 0);
+   else
+      sched_release(get_model(), s, offset, count);
 }
 
 void x_resolve_signal(sig_shared_t *ss, rt_resolution_t *resolution)
@@ -22,6 +22,7 @@
 #include "mask.h"
 #include "opt.h"
 #include "rt/mspace.h"
+#include "thread.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -41,8 +42,10 @@
 #define LINE_SIZE  32
 #define LINE_WORDS (LINE_SIZE / sizeof(intptr_t))
 
+#define ROOT_CHUNK_SIZE 1024
+#define MAX_ROOT_CHUNKS 4096
+
 typedef A(mptr_t)       mptr_list_t;
-typedef A(void *)       root_list_t;
 typedef A(uint64_t)     work_list_t;
 typedef A(const char *) str_list_t;
 
@@ -59,18 +62,36 @@ struct _free_list {
    size_t       size;
 };
 
+// State of a thread which may access the mspace concurrently with
+// other threads between calls to mspace_attach_thread and
+// mspace_detach_thread
+typedef struct {
+   intptr_t         *stack_top;
+   intptr_t         *stack_limit;
+   struct cpu_state *cpu;
+   int               depth;
+} mutator_t;
+
 struct _mspace {
    size_t           maxsize;
    unsigned         maxlines;
    char            *space;
    bit_mask_t       headmask;
-   root_list_t      roots;
+   nvc_lock_t       lock;
+   unsigned         nroots;
+   void           **rootchunks[MAX_ROOT_CHUNKS];
    mptr_list_t      free_mptrs;
    mspace_oom_fn_t  oomfn;
    free_list_t     *free_list;
    uint64_t         create_us;
    unsigned         total_gc;
    unsigned         num_cycles;
+   mutator_t        mutators[MAX_THREADS];
+   int              attached;
+   int              parked;
+   int              owner;
+   int              stop_depth;
+   int              stopping;
 #ifdef DEBUG
    str_list_t       mptr_names;
    bool             stress;
@@ -97,7 +118,8 @@ mspace_t *mspace_new(size_t size)
    mask_init(&(m->headmask), m->maxlines);
    mask_setall(&(m->headmask));
 
-   APUSH(m->roots, NULL);    // Dummy MPTR_INVALID root
+   m->rootchunks[0] = xcalloc_array(ROOT_CHUNK_SIZE, sizeof(void *));
+   m->nroots = 1;    // Dummy MPTR_INVALID root
    DEBUG_ONLY(APUSH(m->mptr_names, NULL));
 
    free_list_t *f = xmalloc(sizeof(free_list_t));
@@ -114,14 +136,14 @@ mspace_t *mspace_new(size_t size)
 void mspace_destroy(mspace_t *m)
 {
 #ifndef NDEBUG
-   if (m->free_mptrs.count != m->roots.count - 1) {
+   if (m->free_mptrs.count != m->nroots - 1) {
       LOCAL_TEXT_BUF tb = tb_new();
       for (int i = 0, n = 0; i < m->mptr_names.count; i++) {
          if (m->mptr_names.items[i] != NULL)
             tb_printf(tb, "%s%s", n++ > 0 ? ", " : "", m->mptr_names.items[i]);
       }
       fatal_trace("destroying mspace with %d live mptrs: %s",
-                  m->roots.count - m->free_mptrs.count - 1, tb_get(tb));
+                  m->nroots - m->free_mptrs.count - 1, tb_get(tb));
    }
 #endif
 
@@ -137,7 +159,9 @@ void mspace_destroy(mspace_t *m)
       free(it);
    }
 
-   ACLEAR(m->roots);
+   for (int i = 0; i < MAX_ROOT_CHUNKS && m->rootchunks[i]; i++)
+      free(m->rootchunks[i]);
+
    DEBUG_ONLY(ACLEAR(m->mptr_names));
    ACLEAR(m->free_mptrs);
    mask_free(&(m->headmask));
@@ -151,51 +175,185 @@ void mspace_stack_limit(void *limit)
    stack_limit = limit;
 }
 
-void *mspace_alloc(mspace_t *m, size_t size)
+__attribute__((noinline))
+static void mspace_park(mspace_t *m)
 {
-   if (size == 0)
-      return NULL;
+   mutator_t *mu = &(m->mutators[thread_id()]);
+   assert(mu->depth > 0);
 
-#ifdef DEBUG
-   if (m->stress)
-      mspace_gc(m);
-#endif
+   struct cpu_state cpu;
+   capture_registers(&cpu);
+
+   mu->cpu = &cpu;
+   mu->stack_top = (intptr_t *)cpu.sp;
+
+   atomic_add(&m->parked, 1);
+
+   while (atomic_load(&m->stopping))
+      spin_wait();
+
+   mu->cpu = NULL;
+   mu->stack_top = NULL;
+
+   atomic_add(&m->parked, -1);
+}
+
+static inline void mspace_safepoint(mspace_t *m)
+{
+   if (unlikely(atomic_load(&m->stopping))
+       && relaxed_load(&m->owner) != thread_id() + 1)
+      mspace_park(m);
+}
+
+void mspace_attach_thread(mspace_t *m)
+{
+   mutator_t *mu = &(m->mutators[thread_id()]);
+   if (mu->depth++ > 0)
+      return;
+
+   if (stack_limit == NULL)
+      fatal_trace("thread attached to mspace without setting stack limit");
+
+   mu->stack_limit = stack_limit;
+
+   // Must not start mutating the heap while another thread has stopped
+   // the world
+   for (;;) {
+      atomic_add(&m->attached, 1);
+      if (!atomic_load(&m->stopping))
+         break;
+
+      atomic_add(&m->attached, -1);
+
+      while (atomic_load(&m->stopping))
+         spin_wait();
+   }
+}
+
+void mspace_detach_thread(mspace_t *m)
+{
+   mutator_t *mu = &(m->mutators[thread_id()]);
+   assert(mu->depth > 0);
+
+   if (--mu->depth == 0)
+      atomic_add(&m->attached, -1);
+}
+
+void mspace_stop_world(mspace_t *m)
+{
+   const int self = thread_id() + 1;
+   if (relaxed_load(&m->owner) == self) {
+      m->stop_depth++;
+      return;
+   }
+
+   mutator_t *mu = &(m->mutators[self - 1]);
+
+   while (!atomic_cas(&m->owner, 0, self)) {
+      if (mu->depth > 0)
+         mspace_safepoint(m);
+      spin_wait();
+   }
+
+   assert(m->stop_depth == 0);
+   m->stop_depth = 1;
+
+   atomic_store(&m->stopping, 1);
+
+   // Wait for every other attached thread to reach a safepoint
+   const int self_attached = mu->depth > 0;
+   while (atomic_load(&m->parked) < atomic_load(&m->attached) - self_attached)
+      spin_wait();
+}
+
+void mspace_start_world(mspace_t *m)
+{
+   assert(relaxed_load(&m->owner) == thread_id() + 1);
+   assert(m->stop_depth > 0);
+
+   if (--m->stop_depth > 0)
+      return;
 
+   atomic_store(&m->stopping, 0);
+
+   // Parked threads must leave the safepoint before another thread can
+   // stop the world again
+   while (atomic_load(&m->parked) > 0)
+      spin_wait();
+
+   atomic_store(&m->owner, 0);
+}
+
+static void *mspace_try_alloc(mspace_t *m, size_t size)
+{
    // Add one to size before rounding up to LINE_SIZE to allow a valid
    // pointer to point at one element past the end of an array
    const int nlines = (size + LINE_SIZE) / LINE_SIZE;
    const size_t asize = nlines * LINE_SIZE;
 
-   int retry = 1;
-   do {
-      for (free_list_t **it = &(m->free_list); *it; it = &((*it)->next)) {
-         assert((*it)->size % LINE_SIZE == 0);
-         if ((*it)->size >= asize) {
-            char *base = (*it)->ptr;
-            assert((uintptr_t)base % LINE_SIZE == 0);
-
-            MSPACE_UNPOISON(base, size);
-
-            const int line = (base - m->space) / LINE_SIZE;
-            mask_set(&(m->headmask), line);
-            if (nlines > 1)
-               mask_clear_range(&(m->headmask), line + 1, nlines - 1);
-
-            if ((*it)->size == asize) {
-               free_list_t *next = (*it)->next;
-               free(*it);
-               *it = next;
-            }
-            else {
-               (*it)->size -= asize;
-               (*it)->ptr += asize;
-            }
-
-            return base;
+   SCOPED_LOCK(m->lock);
+
+   for (free_list_t **it = &(m->free_list); *it; it = &((*it)->next)) {
+      assert((*it)->size % LINE_SIZE == 0);
+      if ((*it)->size >= asize) {
+         char *base = (*it)->ptr;
+         assert((uintptr_t)base % LINE_SIZE == 0);
+
+         MSPACE_UNPOISON(base, size);
+
+         const int line = (base - m->space) / LINE_SIZE;
+         mask_set(&(m->headmask), line);
+         if (nlines > 1)
+            mask_clear_range(&(m->headmask), line + 1, nlines - 1);
+
+         if ((*it)->size == asize) {
+            free_list_t *next = (*it)->next;
+            free(*it);
+            *it = next;
          }
+         else {
+            (*it)->size -= asize;
+            (*it)->ptr += asize;
+         }
+
+         return base;
       }
+   }
 
+   return NULL;
+}
+
+static void mspace_collect(mspace_t *m)
+{
+   mspace_stop_world(m);
+
+   {
+      SCOPED_LOCK(m->lock);
       mspace_gc(m);
+   }
+
+   mspace_start_world(m);
+}
+
+void *mspace_alloc(mspace_t *m, size_t size)
+{
+   if (size == 0)
+      return NULL;
+
+   mspace_safepoint(m);
+
+#ifdef DEBUG
+   if (m->stress)
+      mspace_collect(m);
+#endif
+
+   int retry = 1;
+   do {
+      void *base = mspace_try_alloc(m, size);
+      if (base != NULL)
+         return base;
+
+      mspace_collect(m);
    } while (retry--);
 
    if (m->oomfn) {
@@ -215,6 +373,8 @@ static void mspace_return_memory(mspace_t *m, char *ptr, size_t size)
    const int nlines = (size + LINE_SIZE) / LINE_SIZE;
    const size_t asize = nlines * LINE_SIZE;
 
+   SCOPED_LOCK(m->lock);
+
    free_list_t **tail;
    for (tail = &(m->free_list); *tail; tail = &((*tail)->next)) {
       if ((*tail)->ptr + (*tail)->size == ptr) {
@@ -260,19 +420,39 @@ void mspace_set_oom_handler(mspace_t *m, mspace_oom_fn_t fn)
    m->oomfn = fn;
 }
 
+static inline void **mptr_slot(mspace_t *m, mptr_t ptr)
+{
+   assert(ptr != MPTR_INVALID);
+   assert(ptr < relaxed_load(&m->nroots));
+
+   // Chunks are never moved once allocated so this does not need to
+   // take the lock
+   return &(m->rootchunks[ptr / ROOT_CHUNK_SIZE][ptr % ROOT_CHUNK_SIZE]);
+}
+
 mptr_t mptr_new(mspace_t *m, const char *name)
 {
+   SCOPED_LOCK(m->lock);
+
    if (m->free_mptrs.count > 0) {
       mptr_t ptr = APOP(m->free_mptrs);
-      assert(AGET(m->roots, ptr) == NULL);
+      assert(*mptr_slot(m, ptr) == NULL);
       assert(AGET(m->mptr_names, ptr) == NULL);
       DEBUG_ONLY(m->mptr_names.items[ptr] = name);
       return ptr;
    }
    else {
-      mptr_t ptr = m->roots.count;
-      APUSH(m->roots, NULL);
+      mptr_t ptr = m->nroots;
+      if (ptr % ROOT_CHUNK_SIZE == 0) {
+         if (ptr / ROOT_CHUNK_SIZE >= MAX_ROOT_CHUNKS)
+            fatal_trace("too many mspace roots");
+
+         m->rootchunks[ptr / ROOT_CHUNK_SIZE] =
+            xcalloc_array(ROOT_CHUNK_SIZE, sizeof(void *));
+      }
+
       DEBUG_ONLY(APUSH(m->mptr_names, name));
+      atomic_store(&m->nroots, ptr + 1);
       return ptr;
    }
 }
@@ -282,11 +462,13 @@ void mptr_free(mspace_t *m, mptr_t *ptr)
    if (*ptr == MPTR_INVALID)
       return;
 
-   assert(*ptr < m->roots.count);
+   SCOPED_LOCK(m->lock);
+
+   assert(*ptr < m->nroots);
    assert(*ptr < m->mptr_names.count);
-   assert(m->free_mptrs.count < m->roots.count);
+   assert(m->free_mptrs.count < m->nroots);
 
-   m->roots.items[*ptr] = NULL;
+   *mptr_slot(m, *ptr) = NULL;
    DEBUG_ONLY(m->mptr_names.items[*ptr] = NULL);
    APUSH(m->free_mptrs, *ptr);
    *ptr = MPTR_INVALID;
@@ -294,19 +476,14 @@ void mptr_free(mspace_t *m, mptr_t *ptr)
 
 void *mptr_get(mspace_t *m, mptr_t ptr)
 {
-   assert(ptr != MPTR_INVALID);
-   assert(ptr < m->roots.count);
-
-   return m->roots.items[ptr];
+   return *mptr_slot(m, ptr);
 }
 
 void mptr_put(mspace_t *m, mptr_t ptr, void *value)
 {
-   assert(ptr != MPTR_INVALID);
-   assert(ptr < m->roots.count);
    assert(value == NULL || is_mspace_ptr(m, value));
 
-   m->roots.items[ptr] = value;
+   *mptr_slot(m, ptr) = value;
 }
 
 void tlab_acquire(mspace_t *m, tlab_t *t)
@@ -388,8 +565,8 @@ static void mspace_gc(mspace_t *m)
    gc_state_t state = {};
    mask_init(&(state.markmask), m->maxlines);
 
-   for (int i = 0; i < m->roots.count; i++)
-      mspace_mark_root(m, (intptr_t)m->roots.items[i], &state);
+   for (int i = 1; i < m->nroots; i++)
+      mspace_mark_root(m, (intptr_t)*mptr_slot(m, i), &state);
 
    struct cpu_state cpu;
    capture_registers(&cpu);
@@ -403,6 +580,19 @@ static void mspace_gc(mspace_t *m)
    for (intptr_t *p = stack_top; p < stack_limit; p++)
       mspace_mark_root(m, *p, &state);
 
+   // Also scan the stacks of any other threads parked at a safepoint
+   for (int i = 0; i < MAX_THREADS; i++) {
+      const mutator_t *mu = &(m->mutators[i]);
+      if (mu->cpu == NULL || i == thread_id())
+         continue;
+
+      for (int j = 0; j < MAX_CPU_REGS; j++)
+         mspace_mark_root(m, mu->cpu->regs[j], &state);
+
+      for (intptr_t *p = mu->stack_top; p < mu->stack_limit; p++)
+         mspace_mark_root(m, *p, &state);
+   }
+
    while (state.worklist.count > 0) {
       const uint64_t enc = APOP(state.worklist);
       const int line = enc >> 32;
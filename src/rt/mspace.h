@@ -70,4 +70,9 @@ void mptr_put(mspace_t *m, mptr_t ptr, void *value);
 
 void mspace_stack_limit(void *limit);
 
+void mspace_attach_thread(mspace_t *m);
+void mspace_detach_thread(mspace_t *m);
+void mspace_stop_world(mspace_t *m);
+void mspace_start_world(mspace_t *m);
+
 #endif   // _RT_MSPACE_H
@@ -44,6 +44,7 @@ typedef enum {
    R_MEMO      = (1 << 0),
    R_IDENT     = (1 << 1),
    R_COMPOSITE = (1 << 2),
+   R_FOLD      = (1 << 3),
 } res_flags_t;
 
 typedef enum {
@@ -53,8 +54,10 @@ typedef enum {
    NET_F_R_IDENT      = (1 << 3),
    NET_F_IMPLICIT     = (1 << 4),
    NET_F_REGISTER     = (1 << 5),
-   // Unused          = (1 << 6),
+   NET_F_COLLAPSED    = (1 << 6),
    NET_F_EFFECTIVE    = (1 << 7),
+   NET_F_LAZY         = (1 << 8),
+   NET_F_STALE        = (1 << 9),
 } net_flags_t;
 
 typedef enum {
@@ -23,6 +23,9 @@
 #include "jit/jit-ffi.h"
 #include "rt/mspace.h"
 #include "rt/rt.h"
+#include "rt/wheel.h"
+
+#include <stddef.h>
 
 typedef void *(*value_fn_t)(rt_nexus_t *);
 
@@ -39,6 +42,15 @@ typedef struct {
    bool            postponed;
 } rt_wakeable_t;
 
+typedef struct {
+   tree_t       decl;
+   rt_signal_t *signal;
+   int64_t      after;
+   int64_t      reject;
+   unsigned     nlits;
+   int16_t      next[0];
+} rt_clock_t;
+
 typedef struct _rt_proc {
    rt_wakeable_t  wakeable;
    tree_t         where;
@@ -48,6 +60,15 @@ typedef struct _rt_proc {
    rt_scope_t    *scope;
    rt_proc_t     *chain;
    mptr_t         privdata;
+   event_t       *timeout;
+   ihash_t       *drivers;
+   bool           exclusive;
+   bool           follower;
+   unsigned       level;
+   rt_proc_t     *fused;
+   rt_clock_t    *clock;
+   uint64_t       prof_runs;
+   uint64_t       prof_ns;
 } rt_proc_t;
 
 typedef enum {
@@ -69,7 +90,7 @@ typedef struct {
 
 typedef struct {
    rt_proc_t    *proc;
-   generation_t  wakeup_gen;
+   wheel_node_t *node;
 } event_proc_t;
 
 struct event {
@@ -125,13 +146,20 @@ typedef enum {
 typedef struct {
    rt_proc_t  *proc;
    rt_nexus_t *nexus;
-   waveform_t  waveforms;
+   rt_value_t  value;
+   waveform_t  pending;
 } rt_driver_t;
 
 typedef struct {
    ffi_closure_t closure;
    unsigned      refcnt;
+   bool          valid;
+   bool          cacheable;
    size_t        bufsz;
+   size_t        insz;
+   uint8_t      *lastin;
+   uint8_t      *memo;
+   unsigned      nlits;
    uint8_t       buffer[0];
 } rt_conv_func_t;
 
@@ -139,13 +167,14 @@ typedef struct {
    rt_nexus_t     *input;
    rt_nexus_t     *output;
    rt_conv_func_t *conv_func;
+   rt_source_t    *chain_output;
 } rt_port_t;
 
 typedef struct _rt_source {
    rt_source_t    *chain_input;
-   rt_source_t    *chain_output;
    source_kind_t   tag;
    unsigned        disconnected : 1;
+   unsigned        pending : 1;
    union {
       rt_port_t    port;
       rt_driver_t  driver;
@@ -166,26 +195,32 @@ typedef struct {
    ffi_closure_t closure;
    res_flags_t   flags;
    int32_t       ileft;
+   int32_t       nlits;
    int8_t        tab2[16][16];
    int8_t        tab1[16];
 } res_memo_t;
 
 typedef struct _rt_nexus {
-   rt_nexus_t   *chain;
-   void         *free_value;
-   rt_net_t     *net;
-   rt_value_t    forcing;
-   uint32_t      width;
-   net_flags_t   flags : 8;
-   uint8_t       size;
-   uint8_t       n_sources;
-   uint8_t       __pad;
-   rt_source_t   sources;
-   rt_signal_t  *signal;
-   rt_source_t  *outputs;
-   void         *resolved;
+   // Fields accessed when updating driving and effective values are
+   // kept together in the first cache line
+   uint32_t        width;
+   net_flags_t     flags : 16;
+   uint8_t         size;
+   uint8_t         n_sources;
+   void           *resolved;
+   rt_net_t       *net;
+   rt_signal_t    *signal;
+   rt_source_t    *outputs;
+   rt_partition_t *partition;
+   void           *free_value;
+   rt_nexus_t     *chain;
+   // The first source is stored inline in the following cache line
+   rt_source_t     sources;
+   rt_value_t      forcing;
 } rt_nexus_t;
 
+STATIC_ASSERT(offsetof(rt_nexus_t, sources) <= 64);
+
 // The code generator knows the layout of this struct
 typedef struct _sig_shared {
    uint32_t size;
@@ -193,9 +228,18 @@ typedef struct _sig_shared {
    uint8_t  data[0];
 } sig_shared_t;
 
+#define INDEX_MAX_LEVELS 6
+
+typedef struct {
+   uint64_t     map;
+   rt_nexus_t **nexus;
+} rt_index_leaf_t;
+
 typedef struct {
-   int         how;
-   rt_nexus_t *nexus[0];
+   unsigned         nleaves;
+   unsigned         nlevels;
+   uint64_t        *summary[INDEX_MAX_LEVELS];
+   rt_index_leaf_t  leaves[0];
 } rt_index_t;
 
 typedef struct _rt_signal {
@@ -206,6 +250,8 @@ typedef struct _rt_signal {
    res_memo_t     *resolution;
    net_flags_t     flags;
    uint32_t        n_nexus;
+   uint64_t        prof_events;
+   uint64_t        prof_transactions;
    rt_nexus_t      nexus;
    sig_shared_t    shared;
 } rt_signal_t;
@@ -0,0 +1,351 @@
+//
+//  Copyright (C) 2022  Nick Gasson
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "util.h"
+#include "array.h"
+#include "rt/wheel.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+//
+// Timing wheel for scheduling future events.  Each slot covers 2^shift
+// time units and the wheel covers WHEEL_SLOTS consecutive slots starting
+// from the cursor.  Events further in the future are kept in an
+// overflow heap until the cursor advances close enough.  Either can
+// remove a cancelled event in O(1) or O(log n) time respectively.
+//
+
+#define WHEEL_BITS  10
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK  (WHEEL_SLOTS - 1)
+#define WHEEL_WORDS (WHEEL_SLOTS / 64)
+#define CHUNK_SIZE  256
+
+struct _wheel_node {
+   wheel_node_t *next;
+   wheel_node_t *prev;
+   uint64_t      when;
+   uint64_t      seq;
+   void         *user;
+   int           heapidx;
+};
+
+typedef struct {
+   wheel_node_t *head;
+   wheel_node_t *tail;
+} wheel_slot_t;
+
+typedef A(wheel_node_t *) node_list_t;
+typedef A(void *) batch_t;
+
+struct _wheel {
+   unsigned      shift;
+   uint64_t      cursor;
+   uint64_t      seq;
+   size_t        count;
+   node_list_t   overflow;
+   wheel_node_t *free_nodes;
+   node_list_t   chunks;
+   batch_t       batch;
+   uint64_t      bitmap[WHEEL_WORDS];
+   wheel_slot_t  slots[WHEEL_SLOTS];
+};
+
+wheel_t *wheel_new(unsigned shift)
+{
+   wheel_t *w = xcalloc(sizeof(wheel_t));
+   w->shift = shift;
+
+   return w;
+}
+
+void wheel_free(wheel_t *w)
+{
+   for (int i = 0; i < w->chunks.count; i++)
+      free(w->chunks.items[i]);
+
+   ACLEAR(w->chunks);
+   ACLEAR(w->batch);
+   ACLEAR(w->overflow);
+
+   free(w);
+}
+
+static wheel_node_t *alloc_node(wheel_t *w)
+{
+   if (w->free_nodes == NULL) {
+      wheel_node_t *chunk = xmalloc_array(CHUNK_SIZE, sizeof(wheel_node_t));
+      APUSH(w->chunks, chunk);
+
+      for (int i = 0; i < CHUNK_SIZE; i++) {
+         chunk[i].next = w->free_nodes;
+         w->free_nodes = &(chunk[i]);
+      }
+   }
+
+   wheel_node_t *n = w->free_nodes;
+   w->free_nodes = n->next;
+   return n;
+}
+
+static void free_node(wheel_t *w, wheel_node_t *n)
+{
+   n->user = NULL;
+   n->next = w->free_nodes;
+   w->free_nodes = n;
+}
+
+static inline bool node_before(wheel_node_t *a, wheel_node_t *b)
+{
+   return a->when < b->when || (a->when == b->when && a->seq < b->seq);
+}
+
+static inline void heap_set(wheel_t *w, int i, wheel_node_t *n)
+{
+   w->overflow.items[i] = n;
+   n->heapidx = i;
+}
+
+static void heap_sift_up(wheel_t *w, int i)
+{
+   wheel_node_t *n = w->overflow.items[i];
+   while (i > 0) {
+      const int parent = (i - 1) / 2;
+      wheel_node_t *p = w->overflow.items[parent];
+      if (!node_before(n, p))
+         break;
+
+      heap_set(w, i, p);
+      i = parent;
+   }
+
+   heap_set(w, i, n);
+}
+
+static void heap_sift_down(wheel_t *w, int i)
+{
+   const int size = w->overflow.count;
+   wheel_node_t *n = w->overflow.items[i];
+
+   for (;;) {
+      int child = 2*i + 1;
+      if (child >= size)
+         break;
+      else if (child + 1 < size
+               && node_before(w->overflow.items[child + 1],
+                              w->overflow.items[child]))
+         child++;
+
+      if (!node_before(w->overflow.items[child], n))
+         break;
+
+      heap_set(w, i, w->overflow.items[child]);
+      i = child;
+   }
+
+   heap_set(w, i, n);
+}
+
+static void heap_push(wheel_t *w, wheel_node_t *n)
+{
+   APUSH(w->overflow, n);
+   heap_sift_up(w, w->overflow.count - 1);
+}
+
+static void heap_remove(wheel_t *w, wheel_node_t *n)
+{
+   const int i = n->heapidx;
+   assert(w->overflow.items[i] == n);
+
+   wheel_node_t *last = APOP(w->overflow);
+   n->heapidx = -1;
+
+   if (last != n) {
+      heap_set(w, i, last);
+      heap_sift_up(w, i);
+      heap_sift_down(w, last->heapidx);
+   }
+}
+
+static void link_node(wheel_t *w, wheel_node_t *n)
+{
+   const unsigned pos = (n->when >> w->shift) & WHEEL_MASK;
+   wheel_slot_t *s = &(w->slots[pos]);
+
+   n->next    = NULL;
+   n->prev    = s->tail;
+   n->heapidx = -1;
+
+   if (s->tail == NULL) {
+      s->head = s->tail = n;
+      w->bitmap[pos / 64] |= UINT64_C(1) << (pos % 64);
+   }
+   else
+      s->tail = s->tail->next = n;
+}
+
+static void unlink_node(wheel_t *w, wheel_node_t *n)
+{
+   const unsigned pos = (n->when >> w->shift) & WHEEL_MASK;
+   wheel_slot_t *s = &(w->slots[pos]);
+
+   if (n->prev == NULL)
+      s->head = n->next;
+   else
+      n->prev->next = n->next;
+
+   if (n->next == NULL)
+      s->tail = n->prev;
+   else
+      n->next->prev = n->prev;
+
+   if (s->head == NULL)
+      w->bitmap[pos / 64] &= ~(UINT64_C(1) << (pos % 64));
+}
+
+static int next_slot(wheel_t *w)
+{
+   // Returns the offset from the cursor of the first non-empty slot
+   const unsigned start = w->cursor & WHEEL_MASK;
+
+   unsigned word = start / 64;
+   uint64_t bits = w->bitmap[word] & (~UINT64_C(0) << (start % 64));
+
+   for (int i = 0; i <= WHEEL_WORDS; i++) {
+      if (bits != 0) {
+         const unsigned pos = word * 64 + __builtin_ctzll(bits);
+         return (pos - start) & WHEEL_MASK;
+      }
+
+      word = (word + 1) % WHEEL_WORDS;
+      bits = w->bitmap[word];
+   }
+
+   return -1;
+}
+
+static uint64_t slot_min(wheel_slot_t *s)
+{
+   assert(s->head != NULL);
+
+   uint64_t min = s->head->when;
+   for (wheel_node_t *n = s->head->next; n; n = n->next)
+      min = MIN(min, n->when);
+
+   return min;
+}
+
+wheel_node_t *wheel_insert(wheel_t *w, uint64_t when, void *user)
+{
+   wheel_node_t *n = alloc_node(w);
+   n->when = when;
+   n->seq  = w->seq++;
+   n->user = user;
+
+   const uint64_t slot = when >> w->shift;
+   assert(slot >= w->cursor);
+
+   if (slot < w->cursor + WHEEL_SLOTS)
+      link_node(w, n);
+   else
+      heap_push(w, n);
+
+   w->count++;
+   return n;
+}
+
+void wheel_cancel(wheel_t *w, wheel_node_t *n)
+{
+   assert(n->user != NULL);
+
+   if (n->heapidx >= 0)
+      heap_remove(w, n);
+   else
+      unlink_node(w, n);
+
+   assert(w->count > 0);
+   w->count--;
+
+   free_node(w, n);
+}
+
+bool wheel_peek(wheel_t *w, uint64_t *when)
+{
+   const int offset = next_slot(w);
+   if (offset >= 0)
+      *when = slot_min(&(w->slots[(w->cursor + offset) & WHEEL_MASK]));
+   else if (w->overflow.count > 0)
+      *when = w->overflow.items[0]->when;
+   else
+      return false;
+
+   return true;
+}
+
+size_t wheel_pop(wheel_t *w, uint64_t *when, void ***batch)
+{
+   // Remove all the events scheduled for the earliest time and return
+   // them in insertion order
+
+   const int offset = next_slot(w);
+   if (offset >= 0)
+      w->cursor += offset;
+   else if (w->overflow.count > 0)
+      w->cursor = w->overflow.items[0]->when >> w->shift;
+   else
+      return 0;
+
+   // Advancing the cursor brings more slots into range
+   while (w->overflow.count > 0) {
+      wheel_node_t *n = w->overflow.items[0];
+      if ((n->when >> w->shift) >= w->cursor + WHEEL_SLOTS)
+         break;
+
+      heap_remove(w, n);
+      link_node(w, n);
+   }
+
+   const unsigned pos = w->cursor & WHEEL_MASK;
+   wheel_slot_t *s = &(w->slots[pos]);
+
+   const uint64_t min = slot_min(s);
+
+   ATRIM(w->batch, 0);
+
+   for (wheel_node_t *n = s->head, *next; n != NULL; n = next) {
+      next = n->next;
+
+      if (n->when == min) {
+         APUSH(w->batch, n->user);
+         unlink_node(w, n);
+         free_node(w, n);
+      }
+   }
+
+   assert(w->count >= w->batch.count);
+   w->count -= w->batch.count;
+
+   *when  = min;
+   *batch = w->batch.items;
+   return w->batch.count;
+}
+
+size_t wheel_size(wheel_t *w)
+{
+   return w->count;
+}
@@ -782,6 +782,33 @@ static tree_t simp_array_ref(tree_t t, simp_ctx_t *ctx)
    return t;
 }
 
+static void simp_may_wait_cb(tree_t t, void *context)
+{
+   bool *may_wait = context;
+
+   if (!tree_has_ref(t) || !(tree_flags(tree_ref(t)) & TREE_F_NEVER_WAITS))
+      *may_wait = true;
+}
+
+static bool simp_is_static_wait(tree_t proc, tree_t wait)
+{
+   // A process whose only wait statement is a final "wait on" without
+   // a condition or timeout is equivalent to a process with the same
+   // sensitivity list
+   if (tree_triggers(wait) == 0)
+      return false;
+   else if (tree_has_value(wait) || tree_has_delay(wait))
+      return false;
+   else if (tree_visit_only(proc, NULL, NULL, T_WAIT) > 1)
+      return false;
+
+   bool may_wait = false;
+   tree_visit_only(proc, simp_may_wait_cb, &may_wait, T_PCALL);
+   tree_visit_only(proc, simp_may_wait_cb, &may_wait, T_PROT_PCALL);
+
+   return !may_wait;
+}
+
 static tree_t simp_process(tree_t t)
 {
    // Replace sensitivity list with a "wait on" statement
@@ -818,10 +845,18 @@ static tree_t simp_process(tree_t t)
    }
 
    // Delete processes that contain just a single wait statement
-   if (tree_stmts(t) == 1 && tree_kind(tree_stmt(t, 0)) == T_WAIT)
+   const int nstmts = tree_stmts(t);
+   if (nstmts == 1 && tree_kind(tree_stmt(t, 0)) == T_WAIT)
       return NULL;
-   else
-      return t;
+   else if (nstmts > 0) {
+      tree_t wait = tree_stmt(t, nstmts - 1);
+      if (tree_kind(wait) == T_WAIT
+          && !(tree_flags(wait) & TREE_F_STATIC_WAIT)
+          && simp_is_static_wait(t, wait))
+         tree_set_flag(wait, TREE_F_STATIC_WAIT);
+   }
+
+   return t;
 }
 
 static tree_t simp_wait(tree_t t)
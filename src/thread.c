@@ -35,7 +35,6 @@
 #include <sanitizer/tsan_interface.h>
 #endif
 
-#define MAX_THREADS  64
 #define LOCK_SPINS   15
 #define MAX_ACTIVEQS 16
 #define MIN_TAKE     8
@@ -152,6 +151,7 @@ struct _workq {
    int            activeidx;
    void          *context;
    bool           parallel;
+   bool           serial;
 };
 
 typedef struct {
@@ -511,6 +511,40 @@ void __scoped_unlock(nvc_lock_t **plock)
    nvc_unlock(*plock);
 }
 
+static bool sema_park_cb(parking_bay_t *bay, void *cookie)
+{
+   nvc_sema_t *sema = cookie;
+
+   // This is called with the park mutex held: only sleep if there has
+   // been no post since the count was last checked
+   return relaxed_load(sema) == 0;
+}
+
+static void sema_unpark_cb(parking_bay_t *bay, void *cookie)
+{
+   nvc_sema_t *sema = cookie;
+   atomic_add(sema, 1);
+}
+
+void nvc_sema_wait(nvc_sema_t *sema)
+{
+   for (;;) {
+      int count = atomic_load(sema);
+      if (count > 0) {
+         if (atomic_cas(sema, count, count - 1))
+            return;
+      }
+      else
+         thread_park(sema, sema_park_cb);
+   }
+}
+
+void nvc_sema_post(nvc_sema_t *sema)
+{
+   // Count incremented in callback with the park mutex held
+   thread_unpark(sema, sema_unpark_cb);
+}
+
 static void push_bot(threadq_t *tq, const task_t *tasks, size_t count)
 {
    const abp_idx_t bot = atomic_load(&tq->bot);
@@ -607,6 +641,12 @@ void workq_do(workq_t *wq, task_fn_t fn, void *arg)
    wq->entryq[wq->wptr++] = (task_t){ fn, wq->context, arg, wq };
 }
 
+void workq_not_thread_safe(workq_t *wq)
+{
+   // Tasks in this queue are always executed on the main thread
+   wq->serial = true;
+}
+
 void workq_scan(workq_t *wq, scan_fn_t fn, void *arg)
 {
    SCOPED_LOCK(wq->lock);
@@ -790,7 +830,8 @@ void workq_start(workq_t *wq)
    if (my_thread->kind != MAIN_THREAD)
       fatal_trace("workq_start can only be called from the main thread");
 
-   wq->parallel = max_workers > 0 && !relaxed_load(&should_stop);
+   wq->parallel = max_workers > 0 && !wq->serial
+      && !relaxed_load(&should_stop);
 
    if (wq->parallel) {
       create_workers(wq->wptr);
@@ -20,6 +20,8 @@
 
 #include <stdint.h>
 
+#define MAX_THREADS 64
+
 #define atomic_add(p, n) __atomic_add_fetch((p), (n), __ATOMIC_SEQ_CST)
 #define atomic_fetch_add(p, n) __atomic_fetch_add((p), (n), __ATOMIC_SEQ_CST)
 #define atomic_load(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
@@ -66,6 +68,11 @@ void __scoped_unlock(nvc_lock_t **plock);
   nvc_lock_t *__lock = &(lock);                         \
   nvc_lock(&(lock));
 
+typedef int nvc_sema_t;
+
+void nvc_sema_wait(nvc_sema_t *sema);
+void nvc_sema_post(nvc_sema_t *sema);
+
 typedef struct _workq workq_t;
 
 typedef void (*task_fn_t)(void *, void *);
@@ -76,6 +83,7 @@ void workq_free(workq_t *wq);
 void workq_start(workq_t *wq);
 void workq_do(workq_t *wq, task_fn_t fn, void *arg);
 void workq_drain(workq_t *wq);
+void workq_not_thread_safe(workq_t *wq);
 void workq_scan(workq_t *wq, scan_fn_t fn, void *arg);
 
 #endif  // _THREAD_H
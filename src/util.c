@@ -1567,6 +1567,29 @@ uint64_t get_timestamp_us()
 #endif
 }
 
+uint64_t get_thread_cpu_ns(void)
+{
+   // CPU time consumed by the calling thread which excludes time spent
+   // waiting or running other threads
+#if defined __MINGW32__
+   FILETIME created, exited, kernel, user;
+   if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user))
+      fatal_errno("GetThreadTimes");
+
+   ULARGE_INTEGER k = { .LowPart = kernel.dwLowDateTime,
+                        .HighPart = kernel.dwHighDateTime };
+   ULARGE_INTEGER u = { .LowPart = user.dwLowDateTime,
+                        .HighPart = user.dwHighDateTime };
+
+   return (k.QuadPart + u.QuadPart) * 100;   // Units of 100 ns
+#else
+   struct timespec ts;
+   if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+      fatal_errno("clock_gettime");
+   return ts.tv_nsec + (ts.tv_sec * UINT64_C(1000000000));
+#endif
+}
+
 #if defined _WIN32 || defined __CYGWIN__
 static struct {
    char illegal;
@@ -241,6 +241,7 @@ typedef struct {
 void nvc_rusage(nvc_rusage_t *ru);
 
 uint64_t get_timestamp_us();
+uint64_t get_thread_cpu_ns(void);
 unsigned nvc_nprocs(void);
 
 void progress(const char *fmt, ...)
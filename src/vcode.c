@@ -5763,6 +5763,209 @@ void vcode_write(vcode_unit_t unit, fbuf_t *f, ident_wr_ctx_t ident_ctx,
    write_u8(0xff, f);  // End marker
 }
 
+typedef struct {
+   uint64_t       hash;
+   loc_file_ref_t file_ref;
+} vcode_hash_t;
+
+static void vcode_hash_u64(vcode_hash_t *h, uint64_t value)
+{
+   // FNV-1a over each byte of the value
+   for (int i = 0; i < 8; i++, value >>= 8)
+      h->hash = (h->hash ^ (value & 0xff)) * UINT64_C(0x100000001b3);
+}
+
+static void vcode_hash_str(vcode_hash_t *h, const char *str)
+{
+   if (str == NULL)
+      vcode_hash_u64(h, 0);
+   else {
+      for (const char *p = str; *p; p++)
+         h->hash = (h->hash ^ (uint8_t)*p) * UINT64_C(0x100000001b3);
+      vcode_hash_u64(h, strlen(str));
+   }
+}
+
+static void vcode_hash_ident(vcode_hash_t *h, ident_t ident)
+{
+   vcode_hash_str(h, ident ? istr(ident) : NULL);
+}
+
+static void vcode_hash_loc(vcode_hash_t *h, const loc_t *loc)
+{
+   // File references are only meaningful within this process so hash
+   // the file name whenever it changes
+   if (loc->file_ref != h->file_ref) {
+      vcode_hash_str(h, loc_file_str(loc));
+      h->file_ref = loc->file_ref;
+   }
+
+   vcode_hash_u64(h, loc->first_line);
+   vcode_hash_u64(h, loc->first_column);
+   vcode_hash_u64(h, loc->line_delta);
+   vcode_hash_u64(h, loc->column_delta);
+}
+
+static void vcode_hash_unit(vcode_unit_t unit, vcode_hash_t *h)
+{
+   vcode_hash_u64(h, unit->kind);
+   vcode_hash_ident(h, unit->name);
+   vcode_hash_u64(h, unit->result);
+   vcode_hash_u64(h, unit->flags);
+   vcode_hash_u64(h, unit->depth);
+   vcode_hash_loc(h, &(unit->loc));
+
+   vcode_hash_u64(h, unit->blocks.count);
+   for (unsigned i = 0; i < unit->blocks.count; i++) {
+      const block_t *b = &(unit->blocks.items[i]);
+      vcode_hash_u64(h, b->ops.count);
+
+      for (unsigned j = 0; j < b->ops.count; j++) {
+         const op_t *op = &(b->ops.items[j]);
+
+         vcode_hash_u64(h, op->kind);
+         vcode_hash_u64(h, op->result);
+         vcode_hash_loc(h, &(op->loc));
+
+         vcode_hash_u64(h, op->args.count);
+         for (unsigned k = 0; k < op->args.count; k++)
+            vcode_hash_u64(h, op->args.items[k]);
+
+         if (OP_HAS_TARGET(op->kind)) {
+            vcode_hash_u64(h, op->targets.count);
+            for (unsigned k = 0; k < op->targets.count; k++)
+               vcode_hash_u64(h, op->targets.items[k]);
+         }
+
+         if (OP_HAS_TYPE(op->kind))
+            vcode_hash_u64(h, op->type);
+         if (OP_HAS_ADDRESS(op->kind))
+            vcode_hash_u64(h, op->address);
+         if (OP_HAS_FUNC(op->kind) || OP_HAS_IDENT(op->kind))
+            vcode_hash_ident(h, op->func);
+         if (OP_HAS_SUBKIND(op->kind))
+            vcode_hash_u64(h, op->subkind);
+         if (OP_HAS_CMP(op->kind))
+            vcode_hash_u64(h, op->cmp);
+         if (OP_HAS_VALUE(op->kind))
+            vcode_hash_u64(h, op->value);
+         if (OP_HAS_REAL(op->kind)) {
+            union { double d; uint64_t i; } u = { .d = op->real };
+            vcode_hash_u64(h, u.i);
+         }
+         if (OP_HAS_DIM(op->kind))
+            vcode_hash_u64(h, op->dim);
+         if (OP_HAS_HOPS(op->kind))
+            vcode_hash_u64(h, op->hops);
+         if (OP_HAS_FIELD(op->kind))
+            vcode_hash_u64(h, op->field);
+         if (OP_HAS_TAG(op->kind))
+            vcode_hash_u64(h, op->tag);
+      }
+   }
+
+   vcode_hash_u64(h, unit->regs.count);
+   for (unsigned i = 0; i < unit->regs.count; i++) {
+      const reg_t *r = &(unit->regs.items[i]);
+      vcode_hash_u64(h, r->type);
+      vcode_hash_u64(h, r->bounds);
+   }
+
+   vcode_hash_u64(h, unit->types.count);
+   for (unsigned i = 0; i < unit->types.count; i++) {
+      const vtype_t *t = &(unit->types.items[i]);
+      vcode_hash_u64(h, t->kind);
+      switch (t->kind) {
+      case VCODE_TYPE_INT:
+      case VCODE_TYPE_OFFSET:
+         vcode_hash_u64(h, t->repr);
+         vcode_hash_u64(h, t->low);
+         vcode_hash_u64(h, t->high);
+         break;
+
+      case VCODE_TYPE_REAL:
+         {
+            union { double d; uint64_t i; } low = { .d = t->rlow };
+            union { double d; uint64_t i; } high = { .d = t->rhigh };
+            vcode_hash_u64(h, low.i);
+            vcode_hash_u64(h, high.i);
+         }
+         break;
+
+      case VCODE_TYPE_CARRAY:
+      case VCODE_TYPE_UARRAY:
+         vcode_hash_u64(h, t->dims);
+         vcode_hash_u64(h, t->size);
+         vcode_hash_u64(h, t->elem);
+         vcode_hash_u64(h, t->bounds);
+         break;
+
+      case VCODE_TYPE_ACCESS:
+      case VCODE_TYPE_POINTER:
+         vcode_hash_u64(h, t->pointed);
+         break;
+
+      case VCODE_TYPE_FILE:
+      case VCODE_TYPE_SIGNAL:
+      case VCODE_TYPE_RESOLUTION:
+      case VCODE_TYPE_CLOSURE:
+         vcode_hash_u64(h, t->base);
+         break;
+
+      case VCODE_TYPE_OPAQUE:
+      case VCODE_TYPE_DEBUG_LOCUS:
+         break;
+
+      case VCODE_TYPE_CONTEXT:
+         vcode_hash_ident(h, t->name);
+         break;
+
+      case VCODE_TYPE_RECORD:
+         vcode_hash_ident(h, t->name);
+         vcode_hash_u64(h, t->fields.count);
+         for (unsigned j = 0; j < t->fields.count; j++)
+            vcode_hash_u64(h, t->fields.items[j]);
+         break;
+      }
+   }
+
+   vcode_hash_u64(h, unit->vars.count);
+   for (unsigned i = 0; i < unit->vars.count; i++) {
+      const var_t *v = &(unit->vars.items[i]);
+      vcode_hash_u64(h, v->type);
+      vcode_hash_u64(h, v->bounds);
+      vcode_hash_ident(h, v->name);
+      vcode_hash_u64(h, v->flags);
+   }
+
+   vcode_hash_u64(h, unit->params.count);
+   for (unsigned i = 0; i < unit->params.count; i++) {
+      const param_t *p = &(unit->params.items[i]);
+      vcode_hash_u64(h, p->type);
+      vcode_hash_u64(h, p->bounds);
+      vcode_hash_ident(h, p->name);
+      vcode_hash_u64(h, p->reg);
+   }
+
+   // Code generated for a nested unit depends on the layout of the
+   // enclosing units
+   if (unit->context != NULL)
+      vcode_hash_unit(unit->context, h);
+   else
+      vcode_hash_u64(h, 0);
+}
+
+uint64_t vcode_unit_hash(vcode_unit_t unit)
+{
+   // Child and sibling units are not included
+   vcode_hash_t h = {
+      .hash     = UINT64_C(0xcbf29ce484222325),
+      .file_ref = FILE_INVALID
+   };
+   vcode_hash_unit(unit, &h);
+   return h.hash;
+}
+
 static vcode_unit_t vcode_read_unit(fbuf_t *f, ident_rd_ctx_t ident_rd_ctx,
                                     loc_rd_ctx_t *loc_rd_ctx)
 {
@@ -304,6 +304,7 @@ void vcode_write(vcode_unit_t unit, fbuf_t *fbuf, ident_wr_ctx_t ident_ctx,
                  loc_wr_ctx_t *loc_ctx);
 vcode_unit_t vcode_read(fbuf_t *fbuf, ident_rd_ctx_t ident_ctx,
                         loc_rd_ctx_t *loc_ctx);
+uint64_t vcode_unit_hash(vcode_unit_t unit);
 
 void vcode_state_save(vcode_state_t *state);
 void vcode_state_restore(const vcode_state_t *state);
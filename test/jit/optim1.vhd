@@ -0,0 +1,57 @@
+package optim1 is
+    function fold(x : integer) return integer;
+    function branch(x : integer) return integer;
+    function locals(x : integer) return integer;
+    function loops(n : integer) return integer;
+end package;
+
+package body optim1 is
+
+    function fold(x : integer) return integer is
+        constant k : integer := 5;
+        variable a, b : integer;
+    begin
+        a := k * 3;
+        b := a + 2;
+        return x + b - a;               -- x + 2
+    end function;
+
+    function branch(x : integer) return integer is
+        variable flag : boolean := true;
+        variable r    : integer := 0;
+    begin
+        if flag then
+            r := x;
+        else
+            r := -x;
+        end if;
+        if x > 10 and flag then
+            r := r * 2;
+        end if;
+        return r;
+    end function;
+
+    function locals(x : integer) return integer is
+        variable a : integer := x;
+        variable b : integer;
+    begin
+        b := a;
+        a := a + 1;
+        b := b + a;                     -- 2x + 1
+        a := b;
+        return a + b;                   -- 4x + 2
+    end function;
+
+    function loops(n : integer) return integer is
+        variable s : integer := 0;
+    begin
+        for i in 1 to n loop
+            s := s + i;
+            if s > 1000 then
+                exit;
+            end if;
+        end loop;
+        return s;
+    end function;
+
+end package body;
@@ -0,0 +1,32 @@
+package osr1 is
+    function churn(n : integer) return integer;
+end package;
+
+package body osr1 is
+
+    type int_vector is array (0 to 3) of integer;
+
+    function churn(n : integer) return integer is
+        variable v : int_vector := (others => 0);
+        variable s : integer := 0;
+    begin
+        for i in 1 to n loop
+            v(0) := v(1) + v(3) + 1;
+            if v(0) > 997 then
+                v(0) := v(0) - 997;
+            end if;
+            v(1) := v(2);
+            v(2) := v(0);
+            v(3) := v(3) + 3;
+            if v(3) > 500 then
+                v(3) := v(3) - 499;
+            end if;
+            s := s + v(1);
+            if s > 1000000 then
+                s := s - 999983;
+            end if;
+        end loop;
+        return s + v(2);
+    end function;
+
+end package body;
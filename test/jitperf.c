@@ -50,13 +50,13 @@ static void print_result(double ops_sec, double usec_op)
       printf("%.1f ops/s; %.1f us/op\n", ops_sec, usec_op);
 }
 
-static void run_benchmark(tree_t pack, tree_t proc, bool interpret)
+static double run_benchmark(tree_t pack, tree_t proc, bool interpret,
+                            bool threaded)
 {
-   color_printf("$!magenta$## %s$$\n\n", istr(tree_ident(proc)));
-
    ident_t name = tree_ident2(proc);
 
    jit_t *j = jit_new();
+   jit_enable_threading(j, threaded);
 
 #ifdef LLVM_HAS_LLJIT
    if (!interpret) {
@@ -98,14 +98,32 @@ static void run_benchmark(tree_t pack, tree_t proc, bool interpret)
       fflush(stdout);
    }
 
+   const double mean_ops_sec = mean(ops_sec + 1, ITERATIONS);
+
    color_printf("\n$!green$--> ");
-   print_result(mean(ops_sec + 1, ITERATIONS), mean(usec_op + 1, ITERATIONS));
+   print_result(mean_ops_sec, mean(usec_op + 1, ITERATIONS));
    color_printf("$$\n");
 
    jit_free(j);
+
+   return mean_ops_sec;
 }
 
-static void find_benchmarks(tree_t pack, const char *filter, bool interpret)
+static void compare_dispatch(tree_t pack, tree_t proc)
+{
+   // Measure the speedup of direct-threaded dispatch over the switch
+   // based interpreter loop
+   color_printf("$!magenta$### Switch dispatch$$\n\n");
+   const double base = run_benchmark(pack, proc, true, false);
+
+   color_printf("$!magenta$### Threaded dispatch$$\n\n");
+   const double threaded = run_benchmark(pack, proc, true, true);
+
+   color_printf("$!green$==> %.2fx speedup$$\n\n", threaded / base);
+}
+
+static void find_benchmarks(tree_t pack, const char *filter, bool interpret,
+                            bool compare)
 {
    ident_t test_i = ident_new("TEST_");
 
@@ -117,8 +135,14 @@ static void find_benchmarks(tree_t pack, const char *filter, bool interpret)
 
       ident_t id = tree_ident(d);
       if (ident_starts_with(id, test_i)
-          && (filter == NULL || strcasestr(istr(id), filter) != NULL))
-         run_benchmark(pack, d, interpret);
+          && (filter == NULL || strcasestr(istr(id), filter) != NULL)) {
+         color_printf("$!magenta$## %s$$\n\n", istr(id));
+
+         if (compare)
+            compare_dispatch(pack, d);
+         else
+            run_benchmark(pack, d, interpret, true);
+      }
    }
 }
 
@@ -142,10 +166,12 @@ static void set_default_options(void)
    opt_set_int(OPT_GC_STRESS, getenv("NVC_GC_STRESS") != 0);
    opt_set_int(OPT_RELAXED, 0);
    opt_set_int(OPT_JIT_LOG, getenv("NVC_JIT_LOG") != NULL);
+   opt_set_int(OPT_PERF_MAP, getenv("NVC_PERF_MAP") != NULL);
    opt_set_int(OPT_WARN_HIDDEN, 0);
    opt_set_int(OPT_RT_TRACE, 0);
    opt_set_int(OPT_STOP_DELTA, 1000);
    opt_set_int(OPT_RT_STATS, 0);
+   opt_set_str(OPT_RT_PROFILE, NULL);
    opt_set_int(OPT_IEEE_WARNINGS, 1);
 }
 
@@ -155,6 +181,8 @@ static void usage(void)
           "\n"
           " -f PATTERN\t\t Only run tests matching PATTERN\n"
           " -L PATH\t\tAdd PATH to library search paths\n"
+          " -s\t\t Print JIT compilation statistics\n"
+          " -t\t\t Compare switch and threaded interpreter dispatch\n"
           "\n");
 
    LOCAL_TEXT_BUF tb = tb_new();
@@ -183,10 +211,10 @@ int main(int argc, char **argv)
 
    opterr = 0;
 
-   bool interpret = false;
+   bool interpret = false, compare = false;
    const char *filter = NULL;
    int c, index = 0;
-   const char *spec = "L:hf:i";
+   const char *spec = "L:hf:ist";
    while ((c = getopt_long(argc, argv, spec, long_options, &index)) != -1) {
       switch (c) {
       case 0:
@@ -204,6 +232,12 @@ int main(int argc, char **argv)
       case 'i':
          interpret = true;
          break;
+      case 's':
+         opt_set_int(OPT_RT_STATS, 1);
+         break;
+      case 't':
+         compare = true;
+         break;
       default:
          if (optopt == 0)
             fatal("unrecognised option $bold$%s$$", argv[optind - 1]);
@@ -250,7 +284,7 @@ int main(int argc, char **argv)
       if (pack == NULL)
          fatal("no package found in %s", argv[i]);
 
-      find_benchmarks(pack, filter, interpret);
+      find_benchmarks(pack, filter, interpret, compare);
    }
 
    eval_free(eval);
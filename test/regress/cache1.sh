@@ -0,0 +1,50 @@
+set -xe
+
+pwd
+which nvc
+
+nvc -a $TESTDIR/regress/cache1.vhd
+
+# First elaboration populates the code cache
+nvc -e -V -gG=1 cache1 -r 2>out1
+grep "code cache has 0 of 1 objects" out1
+grep "G = 1" out1
+
+# Unchanged design links the cached object
+nvc -e -V -gG=1 cache1 -r 2>out2
+grep "code cache has 1 of 1 objects" out2
+grep "G = 1" out2
+
+# Different generic value must not reuse the cached object
+nvc -e -V -gG=2 cache1 -r 2>out3
+grep "code cache has 0 of 1 objects" out3
+grep "G = 2" out3
+
+# Cache is limited to NVC_CACHE_MAX objects with the least recently
+# used evicted first
+NVC_CACHE_MAX=1 nvc -e -V -gG=3 cache1 -r 2>out4
+grep "code cache has 0 of 1 objects" out4
+grep "G = 3" out4
+[ $(ls work/_NVC_CACHE | wc -l) -eq 1 ]
+
+NVC_CACHE_MAX=1 nvc -e -V -gG=1 cache1 -r 2>out5
+grep "code cache has 0 of 1 objects" out5
+[ $(ls work/_NVC_CACHE | wc -l) -eq 1 ]
+
+NVC_CACHE_MAX=1 nvc -e -V -gG=1 cache1 -r 2>out6
+grep "code cache has 1 of 1 objects" out6
+
+# Removing the cache directory is always safe
+rm -rf work/_NVC_CACHE
+nvc -e -V -gG=1 cache1 -r 2>out7
+grep "code cache has 0 of 1 objects" out7
+grep "G = 1" out7
+
+# Invalid limits are ignored with a warning and do not empty the cache
+NVC_CACHE_MAX=junk nvc -e -V -gG=1 cache1 -r 2>out8
+grep "ignoring invalid NVC_CACHE_MAX value 'junk'" out8
+grep "code cache has 1 of 1 objects" out8
+
+NVC_CACHE_MAX=0 nvc -e -V -gG=2 cache1 -r 2>out9
+grep "ignoring invalid NVC_CACHE_MAX value '0'" out9
+[ $(ls work/_NVC_CACHE | wc -l) -eq 2 ]
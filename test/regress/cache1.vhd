@@ -0,0 +1,14 @@
+entity cache1 is
+    generic ( G : integer := 1 );
+end entity;
+
+architecture test of cache1 is
+begin
+
+    process is
+    begin
+        report "G = " & integer'image(G);
+        wait;
+    end process;
+
+end architecture;
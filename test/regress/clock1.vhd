@@ -0,0 +1,77 @@
+library ieee;
+use ieee.std_logic_1164.all;
+
+entity clock1 is
+end entity;
+
+architecture test of clock1 is
+    signal clk1 : bit := '0';
+    signal clk2 : std_logic := '0';
+    signal clk3 : boolean := false;
+    signal clk4 : std_logic := 'U';
+    signal n1, n2, n3, n4 : natural;
+begin
+
+    -- Free-running clock generators serviced by the scheduler
+    clk1 <= not clk1 after 5 ns;
+    clk2 <= not clk2 after 2 ns;
+    clk3 <= transport not clk3 after 10 ns;
+    clk4 <= not clk4 after 1 ns;        -- Stuck at 'U'
+
+    count1: process (clk1) is
+    begin
+        if clk1'event then
+            assert now = (n1 + 1) * 5 ns;
+            n1 <= n1 + 1;
+        end if;
+    end process;
+
+    count2: process (clk2) is
+    begin
+        if rising_edge(clk2) then
+            n2 <= n2 + 1;
+        end if;
+    end process;
+
+    count3: process (clk3) is
+    begin
+        if clk3 then
+            n3 <= n3 + 1;
+        end if;
+    end process;
+
+    count4: process (clk4) is
+    begin
+        if clk4'event then
+            n4 <= n4 + 1;
+        end if;
+    end process;
+
+    check: process is
+    begin
+        wait for 99 ns;
+        assert n1 = 19;
+        assert n2 = 25;
+        assert n3 = 5;
+        assert n4 = 0;
+        assert clk1 = '1';
+        assert clk4 = 'U';
+
+        -- The next value is not known for 'X' so the process must run
+        -- normally here
+        clk2 <= force 'X';
+        wait for 1 ns;
+        assert clk2 = 'X';
+        clk2 <= release;
+        wait for 1 ns;
+        assert clk2 = '1';
+        wait for 2 ns;
+        assert clk2 = '0';
+        wait for 2 ns;
+        assert clk2 = '1';
+        assert n2 = 26;
+
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,19 @@
+entity clock2 is
+end entity;
+
+architecture test of clock2 is
+
+    function noisy_not (x : bit) return bit is
+    begin
+        report "toggle " & bit'image(x);
+        return not x;
+    end function;
+
+    signal clk : bit := '0';
+begin
+
+    -- Not serviced by the scheduler as the function must report each
+    -- time it is called
+    clk <= noisy_not(clk) after 5 ns;
+
+end architecture;
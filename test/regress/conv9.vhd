@@ -0,0 +1,110 @@
+library ieee;
+use ieee.std_logic_1164.all;
+
+package pack is
+    function sl_to_bit (x : std_logic) return bit;
+    function slv_to_bv (x : std_logic_vector) return bit_vector;
+    impure function sl_stamp (x : std_logic) return time;
+    impure function slv_stamp (x : std_logic_vector) return time;
+end package;
+
+package body pack is
+    function sl_to_bit (x : std_logic) return bit is
+    begin
+        return to_bit(x, '1');          -- Metavalues map to '1'
+    end function;
+
+    function slv_to_bv (x : std_logic_vector) return bit_vector is
+    begin
+        return to_bitvector(x);
+    end function;
+
+    -- Impure functions must be called for every update and never
+    -- memoised or cached
+    impure function sl_stamp (x : std_logic) return time is
+    begin
+        return now;
+    end function;
+
+    impure function slv_stamp (x : std_logic_vector) return time is
+    begin
+        return now;
+    end function;
+end package body;
+
+-------------------------------------------------------------------------------
+
+entity sub is
+    port ( b  : in bit;
+           bv : in bit_vector(3 downto 0);
+           t1 : in time;
+           t2 : in time );
+end entity;
+
+architecture test of sub is
+begin
+
+    check: process is
+    begin
+        assert b = '0';
+        assert bv = "0000";
+        wait for 1 ns;
+        assert b = '1';
+        assert bv = "1010";
+        assert t1 = 0 ns;
+        assert t2 = 0 ns;
+        wait for 1 ns;
+        assert b = '0';
+        assert bv = "0101";
+        assert t1 = 1 ns;
+        assert t2 = 1 ns;
+        wait for 1 ns;
+        assert b = '1';
+        assert bv = "0101";
+        assert t1 = 2 ns;
+        assert t2 = 2 ns;               -- Input unchanged
+        wait for 1 ns;
+        assert b = '0';
+        assert bv = "1111";
+        assert t1 = 3 ns;
+        assert t2 = 3 ns;
+        wait;
+    end process;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+library ieee;
+use ieee.std_logic_1164.all;
+use work.pack.all;
+
+entity conv9 is
+end entity;
+
+architecture test of conv9 is
+    signal s : std_logic := '0';
+    signal v : std_logic_vector(3 downto 0) := "0000";
+begin
+
+    u: entity work.sub
+        port map ( sl_to_bit(s), slv_to_bv(v), sl_stamp(s), slv_stamp(v) );
+
+    stim: process is
+    begin
+        s <= '1';
+        v <= "1010";
+        wait for 1 ns;
+        s <= '0';
+        v <= "0101";
+        wait for 1 ns;
+        s <= 'X';
+        v <= "0101";                    -- Transaction with the same value
+        wait for 1 ns;
+        s <= 'L';
+        v <= "HHHH";
+        wait for 1 ns;
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,49 @@
+entity driver16 is
+end entity;
+
+architecture test of driver16 is
+    signal x : integer := 0;
+    signal v : bit_vector(1 to 4);
+begin
+
+    p1: process is
+    begin
+        -- Multi-element waveform spills past the first transaction
+        x <= transport 1 after 1 ns, 2 after 2 ns, 3 after 3 ns;
+        wait for 1 ns;
+        assert x = 1;
+        wait for 1 ns;
+        assert x = 2;
+        wait for 1 ns;
+        assert x = 3;
+
+        -- Earliest pending transaction is rejected and the next one
+        -- takes its place
+        x <= transport 4 after 1 ns, 5 after 2 ns;
+        x <= reject 2 ns inertial 5 after 3 ns;
+        wait for 1 ns;
+        assert x = 3;
+        wait for 1 ns;
+        assert x = 5;
+        wait for 1 ns;
+        assert x = 5;
+
+        -- New transaction deletes all later ones
+        x <= transport 6 after 2 ns, 7 after 3 ns;
+        x <= transport 8 after 1 ns;
+        wait for 5 ns;
+        assert x = 8;
+
+        -- Split the nexus while transactions are pending
+        v <= transport "1010" after 1 ns, "1111" after 2 ns;
+        wait for 0 ns;
+        v(2) <= transport '1' after 2 ns;
+        wait for 1 ns;
+        assert v = "1010";
+        wait for 1 ns;
+        assert v = "1111";
+
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,66 @@
+library ieee;
+use ieee.std_logic_1164.all;
+
+entity driver17 is
+end entity;
+
+architecture test of driver17 is
+    type abc is ('a', 'b', 'c');
+    type abc_vector is array (natural range <>) of abc;
+
+    -- Not associative so cannot be folded pairwise
+    function count_b (x : abc_vector) return abc is
+        variable n : natural := 0;
+    begin
+        for i in x'range loop
+            if x(i) = 'b' then
+                n := n + 1;
+            end if;
+        end loop;
+        case n is
+            when 0 => return 'a';
+            when 1 => return 'b';
+            when others => return 'c';
+        end case;
+    end function;
+
+    subtype rabc is count_b abc;
+    type rabc_vector is array (natural range <>) of rabc;
+
+    signal bus64 : std_logic_vector(63 downto 0);
+    signal v     : rabc_vector(1 to 20);
+begin
+
+    d1: bus64 <= (others => 'Z'),
+                 (63 downto 32 => 'Z', 31 downto 0 => '1') after 1 ns,
+                 (others => 'Z') after 3 ns;
+    d2: bus64 <= (others => 'Z'),
+                 (63 downto 32 => '0', 31 downto 0 => 'Z') after 1 ns,
+                 (others => 'L') after 2 ns;
+    d3: bus64 <= (others => 'Z'), (others => 'H') after 2 ns,
+                 (others => 'Z') after 4 ns;
+    d4: bus64 <= (others => 'Z'), (63 => '1', others => 'Z') after 4 ns;
+
+    d5: v <= (others => 'b');
+    d6: v <= (others => 'a'), (others => 'b') after 1 ns;
+    d7: v <= (others => 'b'), (others => 'a') after 2 ns;
+
+    check: process is
+    begin
+        wait for 0 ns;
+        assert bus64 = (63 downto 0 => 'Z');
+        assert v = (1 to 20 => 'c');
+        wait for 1 ns;
+        assert bus64 = X"00000000ffffffff";
+        assert v = (1 to 20 => 'c');
+        wait for 1 ns;
+        assert bus64 = (31 downto 0 => 'W') & (31 downto 0 => '1');
+        assert v = (1 to 20 => 'c');
+        wait for 1 ns;
+        assert bus64 = (63 downto 0 => 'W');
+        wait for 1 ns;
+        assert bus64 = '1' & (62 downto 0 => 'L');
+        wait;
+    end process;
+
+end architecture;
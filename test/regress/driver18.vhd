@@ -0,0 +1,95 @@
+entity driver18 is
+end entity;
+
+architecture test of driver18 is
+    type abc is ('a', 'b', 'c');
+    type abc_vector is array (natural range <>) of abc;
+
+    -- Commutative but not associative: folding pairwise gives a
+    -- different answer depending on how the drivers are grouped
+    function mean (x : abc_vector) return abc is
+        variable sum : natural := 0;
+    begin
+        if x'length = 0 then
+            return 'a';
+        end if;
+        for i in x'range loop
+            sum := sum + abc'pos(x(i));
+        end loop;
+        return abc'val(sum / x'length);
+    end function;
+
+    -- Associative so can be folded over any number of drivers
+    function max (x : abc_vector) return abc is
+        variable r : abc := 'a';
+    begin
+        for i in x'range loop
+            if x(i) > r then
+                r := x(i);
+            end if;
+        end loop;
+        return r;
+    end function;
+
+    subtype mabc is mean abc;
+    type mabc_vector is array (natural range <>) of mabc;
+
+    subtype xabc is max abc;
+    type xabc_vector is array (natural range <>) of xabc;
+
+    signal s4 : mabc;
+    signal v4 : mabc_vector(1 to 20);
+    signal v5 : mabc_vector(1 to 20);
+    signal x5 : xabc_vector(1 to 20);
+begin
+
+    -- Four drivers: (a,a,b,c) folds to 'b' left to right but the mean
+    -- is 'a'
+    e1: s4 <= 'a', 'c' after 2 ns;
+    e2: s4 <= 'a', 'c' after 2 ns;
+    e3: s4 <= 'b';
+    e4: s4 <= 'c', 'a' after 1 ns;
+
+    f1: v4 <= (others => 'a'), (others => 'c') after 2 ns;
+    f2: v4 <= (others => 'a'), (others => 'c') after 2 ns;
+    f3: v4 <= (others => 'b');
+    f4: v4 <= (others => 'c'), (others => 'a') after 1 ns;
+
+    -- Five drivers
+    g1: v5 <= (others => 'a'), (others => 'c') after 1 ns;
+    g2: v5 <= (others => 'a'), (others => 'c') after 2 ns;
+    g3: v5 <= (others => 'a'), (others => 'c') after 2 ns;
+    g4: v5 <= (others => 'c'), (others => 'a') after 3 ns;
+    g5: v5 <= (others => 'c');
+
+    h1: x5 <= (others => 'a');
+    h2: x5 <= (others => 'a');
+    h3: x5 <= (others => 'a'), (others => 'b') after 1 ns;
+    h4: x5 <= (others => 'a');
+    h5: x5 <= (others => 'a'), (1 => 'c', others => 'a') after 2 ns,
+              (others => 'a') after 3 ns;
+
+    check: process is
+    begin
+        wait for 0 ns;
+        assert s4 = 'a';                -- (0 + 0 + 1 + 2) / 4
+        assert v4 = (1 to 20 => 'a');
+        assert v5 = (1 to 20 => 'a');   -- (0 + 0 + 0 + 2 + 2) / 5
+        assert x5 = (1 to 20 => 'a');
+        wait for 1 ns;
+        assert s4 = 'a';                -- (0 + 0 + 1 + 0) / 4
+        assert v4 = (1 to 20 => 'a');
+        assert v5 = (1 to 20 => 'b');   -- (2 + 0 + 0 + 2 + 2) / 5
+        assert x5 = (1 to 20 => 'b');
+        wait for 1 ns;
+        assert s4 = 'b';                -- (2 + 2 + 1 + 0) / 4
+        assert v4 = (1 to 20 => 'b');
+        assert v5 = (1 to 20 => 'c');
+        assert x5 = 'c' & (2 to 20 => 'b');
+        wait for 1 ns;
+        assert v5 = (1 to 20 => 'b');   -- (2 + 2 + 2 + 0 + 2) / 5
+        assert x5 = (1 to 20 => 'b');
+        wait;
+    end process;
+
+end architecture;
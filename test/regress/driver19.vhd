@@ -0,0 +1,28 @@
+entity driver19 is
+end entity;
+
+architecture test of driver19 is
+    -- Associative but reports with three or more drivers so must not
+    -- be folded over the memoised table
+    function resolved (x : bit_vector) return bit is
+        variable r : bit := '0';
+    begin
+        for i in x'range loop
+            r := r or x(i);
+        end loop;
+        if x'length > 2 then
+            report "resolved " & integer'image(x'length) & " drivers";
+        end if;
+        return r;
+    end function;
+
+    subtype rbit is resolved bit;
+
+    signal s : rbit;
+begin
+
+    p1: s <= '0';
+    p2: s <= '0', '1' after 1 ns;
+    p3: s <= '0';
+
+end architecture;
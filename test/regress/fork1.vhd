@@ -0,0 +1,42 @@
+use std.env.all;
+
+entity fork1 is
+end entity;
+
+architecture test of fork1 is
+    signal count : natural := 0;
+    signal seed  : natural;
+begin
+
+    -- Warm up period before the simulation is forked
+    counter: process is
+    begin
+        for i in 1 to 10 loop
+            wait for 1 ns;
+            count <= count + 1;
+        end loop;
+        wait;
+    end process;
+
+    stim: process is
+        variable before : natural;
+    begin
+        wait for 5 ns;
+        before := count;
+        wait for 1 ns;
+
+        -- Each child is given a different index
+        seed <= natural'value(getenv("NVC_FORK_INDEX"));
+        wait for 0 ns;
+        report "fork " & integer'image(seed) & " count "
+            & integer'image(count);
+        assert before = 4;
+        assert count = 6;
+        assert seed = 0 or seed = 1;
+
+        wait for 10 ns;
+        assert count = 10;
+        wait;
+    end process;
+
+end architecture;
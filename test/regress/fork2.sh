@@ -0,0 +1,28 @@
+set -xe
+
+pwd
+which nvc
+
+nvc --std=2019 -a $TESTDIR/regress/fork2.vhd
+
+# Every child runs to completion and exits successfully
+nvc --std=2019 -e fork2 -r --fork=3 --fork-at=5ns
+test "$(cat fork0.txt)" = "count 6"
+test "$(cat fork1.txt)" = "count 6"
+test "$(cat fork2.txt)" = "count 6"
+test ! -f fork3.txt
+
+# The parent fails if any child fails
+rm -f fork*.txt
+if nvc --std=2019 -e -gfail_index=1 fork2 -r --fork=2 --fork-at=5ns 2>err
+then
+    exit 1
+fi
+grep "fork 1 failed" err
+test -f fork0.txt
+
+# Forking at a time requires a number of children
+if nvc --std=2019 -e fork2 -r --fork-at=5ns 2>err; then
+    exit 1
+fi
+grep -- "--fork-at" err
@@ -0,0 +1,34 @@
+use std.env.all;
+use std.textio.all;
+
+entity fork2 is
+    generic ( fail_index : integer := -1 );
+end entity;
+
+architecture test of fork2 is
+    signal count : natural := 0;
+begin
+
+    count <= count + 1 after 1 ns when count < 10;
+
+    stim: process is
+        file f       : text;
+        variable l   : line;
+        variable idx : natural;
+    begin
+        wait for 6 ns;
+
+        -- Each child writes a file named after its index so the test
+        -- script can check every child saw a distinct index
+        idx := natural'value(getenv("NVC_FORK_INDEX"));
+        file_open(f, "fork" & integer'image(idx) & ".txt", WRITE_MODE);
+        write(l, string'("count "));
+        write(l, count);
+        writeline(f, l);
+        file_close(f);
+
+        assert idx /= fail_index report "fork failed" severity failure;
+        wait;
+    end process;
+
+end architecture;
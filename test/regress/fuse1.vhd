@@ -0,0 +1,117 @@
+entity fuse1_sub is
+    port ( clk : in bit;
+           q   : out natural );
+end entity;
+
+architecture test of fuse1_sub is
+    signal r : natural;
+begin
+
+    p1: process (clk) is
+    begin
+        if clk'event and clk = '1' then
+            r <= r + 1;
+        end if;
+    end process;
+
+    p2: process (clk) is
+    begin
+        if clk'event and clk = '1' then
+            q <= r;
+        end if;
+    end process;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity fuse1 is
+end entity;
+
+architecture test of fuse1 is
+    type nat_vector is array (natural range <>) of natural;
+
+    function sum (x : nat_vector) return natural is
+        variable r : natural := 0;
+    begin
+        for i in x'range loop
+            r := r + x(i);
+        end loop;
+        return r;
+    end function;
+
+    subtype rnat is sum natural;
+
+    signal clk1, clk2, rst : bit;
+    signal count           : nat_vector(1 to 8);
+    signal total           : rnat;
+    signal q1, q2          : natural;
+begin
+
+    -- These have the same sensitivity in a different order
+    a1: process (clk1, rst) is
+    begin
+        if rst = '1' then
+            count(1) <= 0;
+        elsif clk1'event and clk1 = '1' then
+            count(1) <= count(1) + 1;
+        end if;
+    end process;
+
+    a2: process (rst, clk1) is
+    begin
+        if rst = '1' then
+            count(2) <= 0;
+        elsif clk1'event and clk1 = '1' then
+            count(2) <= count(2) + 2;
+        end if;
+    end process;
+
+    -- Each generated process is woken by the same signal
+    g: for i in 3 to 8 generate
+        process (clk1) is
+        begin
+            if clk1'event and clk1 = '1' then
+                count(i) <= count(i) + i;
+                total <= i;
+            end if;
+        end process;
+    end generate;
+
+    -- Different signals connected to the same entity
+    u1: entity work.fuse1_sub port map ( clk1, q1 );
+    u2: entity work.fuse1_sub port map ( clk2, q2 );
+
+    stim: process is
+    begin
+        for i in 1 to 5 loop
+            clk1 <= '1';
+            wait for 1 ns;
+            clk1 <= '0';
+            wait for 1 ns;
+        end loop;
+
+        assert count = (5, 10, 15, 20, 25, 30, 35, 40);
+        assert total = 33;
+        assert q1 = 4;
+        assert q2 = 0;
+
+        clk2 <= '1';
+        wait for 1 ns;
+        assert q2 = 0;
+        clk2 <= '0';
+        wait for 1 ns;
+        clk2 <= '1';
+        wait for 1 ns;
+        assert q2 = 1;
+        assert q1 = 4;
+
+        rst <= '1';
+        wait for 1 ns;
+        assert count(1 to 2) = (0, 0);
+        assert count(3) = 15;
+
+        wait;
+    end process;
+
+end architecture;
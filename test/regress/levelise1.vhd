@@ -0,0 +1,97 @@
+entity levelise1 is
+end entity;
+
+architecture test of levelise1 is
+    signal x, a, b, y : bit;
+    signal clk, gclk  : bit;
+    signal en         : bit := '1';
+    signal d, q       : natural;
+    signal l, lq      : bit;
+    signal nevents    : natural;
+    signal c, z       : bit;
+    signal nruns      : natural;
+begin
+
+    -- Reconvergent paths from X to Y which glitch when each process
+    -- runs in a separate delta cycle
+    a <= not x;
+    b <= not a;
+    y <= x xor b;
+
+    -- Y is observed through 'event so its glitches remain visible
+    count: process (y) is
+    begin
+        if y'event then
+            nevents <= nevents + 1;
+        end if;
+    end process;
+
+    -- Nothing observes the delta cycles of Z so it settles without
+    -- glitching
+    c <= not x;
+    z <= x xor not c;
+
+    runs: process (z) is
+    begin
+        nruns <= nruns + 1;
+    end process;
+
+    -- Gated clock and register fed by combinational logic
+    gclk <= clk and en;
+    d <= q + 1;
+
+    reg: process (gclk) is
+    begin
+        if gclk'event and gclk = '1' then
+            q <= d;
+        end if;
+    end process;
+
+    -- Combinational loop is scheduled normally
+    l <= x when en = '1' else lq;
+    lq <= l;
+
+    stim: process is
+        variable start, zstart : natural;
+    begin
+        wait for 1 ns;
+        assert y = '0';
+        assert b = x;
+        assert z = '0';
+
+        start := nevents;
+        zstart := nruns;
+
+        for i in 1 to 5 loop
+            x <= not x;
+            wait for 1 ns;
+            assert b = x;
+            assert y = '0';
+            assert z = '0';
+            assert lq = x;
+        end loop;
+
+        assert nevents = start + 10 report integer'image(nevents);
+        assert nruns = zstart report integer'image(nruns);
+
+        for i in 1 to 3 loop
+            clk <= '1';
+            wait for 1 ns;
+            clk <= '0';
+            wait for 1 ns;
+        end loop;
+
+        assert q = 3;
+        assert d = 4;
+
+        en <= '0';
+        x <= '0';
+        clk <= '1';
+        wait for 1 ns;
+        assert q = 3;
+        assert lq = '1';
+
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,98 @@
+entity parallel1 is
+end entity;
+
+architecture test of parallel1 is
+    type int_vector is array (natural range <>) of integer;
+
+    function sum (x : int_vector) return integer is
+        variable r : integer := 0;
+    begin
+        for i in x'range loop
+            r := r + x(i);
+        end loop;
+        return r;
+    end function;
+
+    function resolved (x : int_vector) return integer is
+    begin
+        return sum(x);
+    end function;
+
+    subtype rint is resolved integer;
+
+    type counter_t is protected
+        procedure increment;
+        impure function get return integer;
+    end protected;
+
+    type counter_t is protected body
+        variable count : integer := 0;
+
+        procedure increment is
+        begin
+            count := count + 1;
+        end procedure;
+
+        impure function get return integer is
+        begin
+            return count;
+        end function;
+    end protected body;
+
+    shared variable counter : counter_t;
+
+    constant N : integer := 8;
+
+    signal clk   : bit := '0';
+    signal vec   : int_vector(0 to N - 1) := (others => 0);
+    signal total : rint := 0;
+    signal done  : bit_vector(0 to N - 1);
+begin
+
+    clkgen: process is
+    begin
+        for i in 1 to 20 loop
+            clk <= not clk after 5 ns;
+            wait for 5 ns;
+        end loop;
+        wait;
+    end process;
+
+    g: for i in 0 to N - 1 generate
+
+        -- Each process drives one element of the same array
+        worker: process (clk) is
+            variable v : integer := 0;
+        begin
+            if clk'event and clk = '1' then
+                v := v + i + 1;
+                vec(i) <= v;
+                total <= v;
+            end if;
+        end process;
+
+        -- Wakes up on a subset of the array in the same cycle as
+        -- the other elements are being updated
+        waiter: process is
+        begin
+            wait until vec(i) = 10 * (i + 1) for 200 ns;
+            assert vec(i) = 10 * (i + 1);
+            assert now = 95 ns;
+            done(i) <= '1';
+            counter.increment;          -- Cannot run concurrently
+            wait;
+        end process;
+
+    end generate;
+
+    check: process is
+    begin
+        wait for 150 ns;
+        assert sum(vec) = 10 * N * (N + 1) / 2;
+        assert total = sum(vec);
+        assert done = (done'range => '1');
+        assert counter.get = N;
+        wait;
+    end process;
+
+end architecture;
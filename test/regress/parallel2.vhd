@@ -0,0 +1,87 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+entity parallel2_sub is
+    port ( clk  : in std_logic;
+           id   : in natural;
+           bus1 : inout std_logic_vector(7 downto 0) );
+end entity;
+
+architecture test of parallel2_sub is
+    signal count : natural := 0;
+begin
+
+    p: process (clk) is
+    begin
+        if rising_edge(clk) then
+            count <= count + 1;
+            if count mod 4 = id then
+                bus1 <= std_logic_vector(to_unsigned(count, 8));
+            else
+                bus1 <= (others => 'Z');
+            end if;
+        end if;
+    end process;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+entity parallel2 is
+end entity;
+
+architecture test of parallel2 is
+    constant N : integer := 4;
+
+    type slv_array is array (natural range <>) of std_logic_vector(7 downto 0);
+    type nat_array is array (natural range <>) of natural;
+
+    function to_nat (x : std_logic_vector) return natural is
+    begin
+        if is_x(x) then
+            return 0;
+        else
+            return to_integer(unsigned(x));
+        end if;
+    end function;
+
+    signal clk   : std_logic := '0';
+    signal buses : slv_array(0 to N - 1);
+    signal value : nat_array(0 to N - 1);
+begin
+
+    clk <= not clk after 5 ns when now < 200 ns;
+
+    g: for i in 0 to N - 1 generate
+
+        -- Each group of four drivers forms an independent partition
+        h: for j in 0 to 3 generate
+            u: entity work.parallel2_sub
+                port map ( clk, j, buses(i) );
+        end generate;
+
+        value(i) <= to_nat(buses(i));
+
+    end generate;
+
+    check: process is
+    begin
+        wait until rising_edge(clk);
+        for k in 1 to 15 loop
+            wait until rising_edge(clk);
+            wait for 1 ns;
+            for i in 0 to N - 1 loop
+                assert buses(i) = std_logic_vector(to_unsigned(k, 8))
+                    report "bad bus " & integer'image(i);
+                assert value(i) = k;
+            end loop;
+        end loop;
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,95 @@
+package parallel3_pack is
+    type rec is record
+        a : natural;
+        b : bit_vector(7 downto 0);
+    end record;
+
+    type rec_array is array (natural range <>) of rec;
+
+    function resolve (v : rec_array) return rec;
+
+    subtype rrec is resolve rec;
+end package;
+
+package body parallel3_pack is
+    function resolve (v : rec_array) return rec is
+        variable r : rec := (a => 0, b => (others => '0'));
+    begin
+        for i in v'range loop
+            r.a := r.a + v(i).a;
+            r.b := r.b or v(i).b;
+        end loop;
+        return r;
+    end function;
+end package body;
+
+-------------------------------------------------------------------------------
+
+use work.parallel3_pack.all;
+
+entity parallel3_sub is
+    port ( clk : in bit;
+           id  : in natural;
+           s   : inout rrec );
+end entity;
+
+architecture test of parallel3_sub is
+begin
+
+    p: process (clk) is
+        variable count : natural := 0;
+        variable mask  : bit_vector(7 downto 0);
+    begin
+        if clk'event and clk = '1' then
+            mask := (others => '0');
+            mask(id) := '1';
+            s <= (a => count, b => mask);
+            count := count + 1;
+        end if;
+    end process;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+use work.parallel3_pack.all;
+
+entity parallel3 is
+end entity;
+
+architecture test of parallel3 is
+    constant N : integer := 4;
+
+    signal clk : bit := '0';
+begin
+
+    clk <= not clk after 5 ns when now < 200 ns;
+
+    g: for i in 0 to N - 1 generate
+        -- Each field of the record is a separate nexus but resolving
+        -- either reads the sources of both
+        signal s : rrec;
+    begin
+
+        h: for j in 0 to 3 generate
+            u: entity work.parallel3_sub
+                port map ( clk, j, s );
+        end generate;
+
+        check: process is
+        begin
+            wait until clk = '1';
+            for k in 1 to 15 loop
+                wait until clk = '1';
+                wait for 1 ns;
+                assert s.a = 4 * k
+                    report "bad a " & integer'image(s.a) & " in group "
+                    & integer'image(i);
+                assert s.b = "00001111";
+            end loop;
+            wait;
+        end process;
+
+    end generate;
+
+end architecture;
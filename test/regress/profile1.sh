@@ -0,0 +1,28 @@
+set -xe
+
+pwd
+which nvc
+
+nvc -a $TESTDIR/regress/profile1.vhd -e profile1 -r --profile=prof.json >out
+
+# Text report
+grep -E '^Time steps +[0-9]+$' out
+grep -E '^Simulation cycles +[0-9]+$' out
+grep -E '^Most cycles +[0-9]+ at ' out
+grep -E '^Cycles per step +Time steps$' out
+grep -E '^Process +Runs +CPU \(us\) +%$' out
+grep -E -i ':count +11 +[0-9.]+ +[0-9.]+$' out
+grep -E '^Signal +Events +Transactions$' out
+grep -E -i ':n +10 +10$' out
+
+# JSON data
+test "$(head -1 prof.json)" = "{"
+test "$(tail -1 prof.json)" = "}"
+grep '"timesteps": ' prof.json
+grep '"cycles_histogram": \[' prof.json
+grep -E -i '"name": ".*:count", "runs": 11, "cpu_ns": [0-9]+' prof.json
+grep -E -i '"name": ".*:n", "events": 10, "transactions": 10' prof.json
+
+if command -v python3 >/dev/null; then
+    python3 -m json.tool prof.json >/dev/null
+fi
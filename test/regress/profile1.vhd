@@ -0,0 +1,17 @@
+entity profile1 is
+end entity;
+
+architecture test of profile1 is
+    signal n : natural;
+begin
+
+    count: process is
+    begin
+        for i in 1 to 10 loop
+            wait for 1 ns;
+            n <= n + 1;
+        end loop;
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,49 @@
+entity signal29 is
+end entity;
+
+architecture test of signal29 is
+    constant N : integer := 300;
+
+    signal s : bit_vector(0 to 4 * N - 1);
+begin
+
+    -- Irregular slices split the signal into many nexuses that are
+    -- not aligned to any power of two
+    g: for i in 0 to N - 1 generate
+        constant lo : integer := (i * 4) + (i mod 2);
+        constant hi : integer := lo + 1 + ((i / 2) mod 2);
+    begin
+        p: process is
+        begin
+            s(lo to hi) <= (others => '1');
+            wait for 1 ns;
+            s(lo) <= '0';
+            wait;
+        end process;
+    end generate;
+
+    check: process is
+        variable count : integer;
+    begin
+        wait for 0 ns;
+        count := 0;
+        for i in s'range loop
+            if s(i) = '1' then
+                count := count + 1;
+            end if;
+        end loop;
+        assert count = 2 * N + N / 2 report integer'image(count);
+        wait for 1 ns;
+        wait for 0 ns;
+        count := 0;
+        for i in s'range loop
+            if s(i) = '1' then
+                count := count + 1;
+            end if;
+        end loop;
+        assert count = N + N / 2 report integer'image(count);
+        assert s(0 to 7) = "01000010";
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,196 @@
+entity signal30_level0 is
+    port (
+        i : in bit_vector(7 downto 0);
+        o : out bit_vector(7 downto 0);
+        n : out natural );
+end entity;
+
+architecture test of signal30_level0 is
+begin
+
+    o <= i;
+
+    -- Counts events seen on the innermost input port
+    process (i) is
+        variable count : natural;
+    begin
+        n <= count;
+        count := count + 1;
+    end process;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity signal30_level1 is
+    port (
+        i : in bit_vector(7 downto 0);
+        o : out bit_vector(7 downto 0);
+        n : out natural );
+end entity;
+
+architecture test of signal30_level1 is
+begin
+
+    b1: block is
+        port (
+            i1 : in bit_vector(7 downto 0);
+            o1 : out bit_vector(7 downto 0);
+            n1 : out natural );
+        port map ( i, o, n );
+    begin
+        b2: block is
+            port (
+                i2 : in bit_vector(7 downto 0);
+                o2 : out bit_vector(7 downto 0);
+                n2 : out natural );
+            port map ( i1, o1, n1 );
+        begin
+            u: entity work.signal30_level0
+                port map ( i2, o2, n2 );
+        end block;
+    end block;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity signal30_level2 is
+    port (
+        i : in bit_vector(7 downto 0);
+        o : out bit_vector(7 downto 0);
+        n : out natural );
+end entity;
+
+architecture test of signal30_level2 is
+begin
+
+    b1: block is
+        port (
+            i1 : in bit_vector(7 downto 0);
+            o1 : out bit_vector(7 downto 0);
+            n1 : out natural );
+        port map ( i, o, n );
+    begin
+        b2: block is
+            port (
+                i2 : in bit_vector(7 downto 0);
+                o2 : out bit_vector(7 downto 0);
+                n2 : out natural );
+            port map ( i1, o1, n1 );
+        begin
+            u: entity work.signal30_level1
+                port map ( i2, o2, n2 );
+        end block;
+    end block;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity signal30_level3 is
+    port (
+        i : in bit_vector(7 downto 0);
+        o : out bit_vector(7 downto 0);
+        n : out natural );
+end entity;
+
+architecture test of signal30_level3 is
+begin
+
+    b1: block is
+        port (
+            i1 : in bit_vector(7 downto 0);
+            o1 : out bit_vector(7 downto 0);
+            n1 : out natural );
+        port map ( i, o, n );
+    begin
+        b2: block is
+            port (
+                i2 : in bit_vector(7 downto 0);
+                o2 : out bit_vector(7 downto 0);
+                n2 : out natural );
+            port map ( i1, o1, n1 );
+        begin
+            u: entity work.signal30_level2
+                port map ( i2, o2, n2 );
+        end block;
+    end block;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity signal30_level4 is
+    port (
+        i : in bit_vector(7 downto 0);
+        o : out bit_vector(7 downto 0);
+        n : out natural );
+end entity;
+
+architecture test of signal30_level4 is
+begin
+
+    b1: block is
+        port (
+            i1 : in bit_vector(7 downto 0);
+            o1 : out bit_vector(7 downto 0);
+            n1 : out natural );
+        port map ( i, o, n );
+    begin
+        b2: block is
+            port (
+                i2 : in bit_vector(7 downto 0);
+                o2 : out bit_vector(7 downto 0);
+                n2 : out natural );
+            port map ( i1, o1, n1 );
+        begin
+            u: entity work.signal30_level3
+                port map ( i2, o2, n2 );
+        end block;
+    end block;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity signal30 is
+end entity;
+
+architecture test of signal30 is
+    signal a, b : bit_vector(7 downto 0);
+    signal n    : natural;
+begin
+
+    -- Twelve levels of hierarchy between A and B with no conversions
+    u: entity work.signal30_level4
+        port map ( a, b, n );
+
+    stim: process is
+    begin
+        a <= X"01";
+        wait for 1 ns;
+        assert b = X"01";
+        assert n = 1;
+        a <= X"02";
+        wait for 0 ns;
+        assert b = X"01";               -- One delta for the assignment
+        wait for 0 ns;
+        assert b = X"02";
+        assert b'event;
+        wait for 1 ns;
+        b(3 downto 0) <= force X"f";
+        a <= X"13";
+        wait for 1 ns;
+        assert b = X"1f";
+        a <= X"24";
+        wait for 1 ns;
+        assert b = X"2f";
+        b(3 downto 0) <= release;
+        wait for 0 ns;
+        assert b = X"24";
+        assert n = 4;
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,16 @@
+entity vhpi6 is
+end entity;
+
+architecture test of vhpi6 is
+    signal x    : integer;
+    signal last : integer;              -- Not read by any process
+begin
+
+    x <= 1 after 1 ns, 2 after 2 ns, 5 after 4 ns;
+
+    process (x) is
+    begin
+        last <= x;
+    end process;
+
+end architecture;
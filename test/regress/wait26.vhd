@@ -0,0 +1,47 @@
+entity wait26 is
+end entity;
+
+architecture test of wait26 is
+    signal clk   : bit := '0';
+    signal x     : integer := 0;
+    signal count : integer := 0;
+begin
+
+    clkgen: process is
+    begin
+        for i in 1 to 10 loop
+            clk <= not clk after 5 ns;
+            wait for 5 ns;
+        end loop;
+        wait;
+    end process;
+
+    -- Only wait statement is the last statement so this is equivalent
+    -- to a process with a sensitivity list
+    counter: process is
+    begin
+        if clk'event and clk = '1' then
+            count <= count + 1;
+        end if;
+        wait on clk;
+    end process;
+
+    -- Same for a signal which is assigned in the same delta cycle
+    follow: process is
+    begin
+        x <= count * 2;
+        wait on count;
+    end process;
+
+    check: process is
+    begin
+        wait for 1 ns;
+        assert count = 0;
+        assert x = 0;
+        wait for 100 ns;
+        assert count = 5 report integer'image(count);
+        assert x = 10 report integer'image(x);
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,10 @@
+set -xe
+
+pwd
+which nvc
+which fstdump
+
+nvc --std=2008 -a $TESTDIR/regress/wave9.vhd -e wave9 -r -w
+
+fstdump wave9.fst > wave9.dump
+diff -u $TESTDIR/regress/gold/wave9.dump wave9.dump
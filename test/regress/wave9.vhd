@@ -0,0 +1,32 @@
+entity sub is
+    port ( i : in integer );
+end entity;
+
+architecture test of sub is
+    signal count : natural;             -- Only read through 'driving_value
+    signal last  : integer;             -- Not read by any process
+begin
+
+    process (i) is
+    begin
+        count <= count'driving_value + 1;
+        last <= i;
+    end process;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity wave9 is
+end entity;
+
+architecture test of wave9 is
+    signal x : integer;
+begin
+
+    x <= 1 after 1 ns, 2 after 2 ns, 5 after 4 ns;
+
+    u: entity work.sub
+        port map ( x );
+
+end architecture;
@@ -51,20 +51,23 @@
 #define ANSI_FG_CYAN    36
 #define ANSI_FG_WHITE   37
 
-#define F_GOLD    (1 << 0)
-#define F_FAIL    (1 << 1)
-#define F_STOP    (1 << 2)
-#define F_VHPI    (1 << 3)
-#define F_2008    (1 << 4)
-#define F_2000    (1 << 5)
-#define F_NOTWIN  (1 << 6)
-#define F_COVER   (1 << 7)
-#define F_2019    (1 << 8)
-#define F_RELAX   (1 << 9)
-#define F_RELAXED (1 << 10)
-#define F_WORKLIB (1 << 11)
-#define F_SHELL   (1 << 12)
-#define F_2002    (1 << 13)
+#define F_GOLD     (1 << 0)
+#define F_FAIL     (1 << 1)
+#define F_STOP     (1 << 2)
+#define F_VHPI     (1 << 3)
+#define F_2008     (1 << 4)
+#define F_2000     (1 << 5)
+#define F_NOTWIN   (1 << 6)
+#define F_COVER    (1 << 7)
+#define F_2019     (1 << 8)
+#define F_RELAX    (1 << 9)
+#define F_RELAXED  (1 << 10)
+#define F_WORKLIB  (1 << 11)
+#define F_SHELL    (1 << 12)
+#define F_2002     (1 << 13)
+#define F_PARALLEL (1 << 14)
+#define F_FORK     (1 << 15)
+#define F_LEVELISE (1 << 16)
 
 typedef struct test test_t;
 typedef struct param param_t;
@@ -87,6 +90,7 @@ struct test {
    test_t    *next;
    int        flags;
    char      *stop;
+   char      *fork;
    param_t   *params;
    char      *relax;
    char      *work;
@@ -342,6 +346,21 @@ static bool parse_test_list(int argc, char **argv)
             test->heapsz = strdup(opt + 2);
          else if (strcmp(opt, "cover") == 0)
             test->flags |= F_COVER;
+         else if (strcmp(opt, "parallel") == 0)
+            test->flags |= F_PARALLEL;
+         else if (strcmp(opt, "levelise") == 0)
+            test->flags |= F_LEVELISE;
+         else if (strncmp(opt, "fork", 4) == 0) {
+            char *count = strchr(opt, '=');
+            if (count == NULL) {
+               fprintf(stderr, "Error on testlist line %d: missing argument to "
+                       "fork option in test %s\n", lineno, name);
+               goto out_close;
+            }
+
+            test->flags |= F_FORK | F_NOTWIN;
+            test->fork = strdup(count + 1);
+         }
          else if (opt[0] == 'g' || opt[0] == '$') {
             char *value = strchr(opt, '=');
             if (value == NULL) {
@@ -699,6 +718,22 @@ static bool run_test(test_t *test)
 
       push_arg(&args, "-r");
 
+      if (test->flags & F_PARALLEL)
+         push_arg(&args, "--parallel");
+
+      if (test->flags & F_LEVELISE)
+         push_arg(&args, "--levelise");
+
+      if (test->flags & F_FORK) {
+         char *at = strchr(test->fork, '@');
+         if (at != NULL) {
+            push_arg(&args, "--fork=%.*s", (int)(at - test->fork), test->fork);
+            push_arg(&args, "--fork-at=%s", at + 1);
+         }
+         else
+            push_arg(&args, "--fork=%s", test->fork);
+      }
+
       if (test->flags & F_STOP)
          push_arg(&args, "--stop-time=%s", test->stop);
 
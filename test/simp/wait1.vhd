@@ -0,0 +1,50 @@
+entity wait1 is
+end entity;
+
+architecture test of wait1 is
+    signal x, y : integer;
+
+    procedure may_wait is
+    begin
+        wait for 1 ns;
+    end procedure;
+
+    procedure never_waits (n : integer) is
+    begin
+        report integer'image(n);
+    end procedure;
+begin
+
+    p1: process is                      -- Static
+    begin
+        report "awake";
+        never_waits(x);
+        wait on x, y;
+    end process;
+
+    p2: process is                      -- Not static
+    begin
+        wait on x;
+        report "awake";
+        wait on y;
+    end process;
+
+    p3: process is                      -- Not static
+    begin
+        may_wait;
+        wait on x;
+    end process;
+
+    p4: process is                      -- Not static
+    begin
+        report "awake";
+        wait on x for 1 ns;
+    end process;
+
+    p5: process is                      -- Not static
+    begin
+        report "awake";
+        wait until x = 1;
+    end process;
+
+end architecture;
@@ -21,13 +21,16 @@
 #include "ident.h"
 #include "jit/jit.h"
 #include "jit/jit-ffi.h"
+#include "jit/jit-priv.h"
 #include "opt.h"
 #include "phase.h"
 #include "scan.h"
+#include "thread.h"
 #include "type.h"
 
 #include <math.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 static jit_handle_t compile_for_test(jit_t *j, const char *name)
 {
@@ -1155,6 +1158,327 @@ START_TEST(test_ffi1)
 }
 END_TEST
 
+static int count_ops(jit_func_t *f, jit_op_t op)
+{
+   int count = 0;
+   for (int i = 0; i < f->nirs; i++) {
+      if (f->irbuf[i].op == op)
+         count++;
+   }
+
+   return count;
+}
+
+static int count_insns(jit_func_t *f)
+{
+   return f->nirs - count_ops(f, J_DEBUG);
+}
+
+static void check_labels(jit_func_t *f)
+{
+   // Every branch target must still be marked as the start of a block
+   for (int i = 0; i < f->nirs; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+      if (ir->arg1.kind == JIT_VALUE_LABEL) {
+         ck_assert_int_lt(ir->arg1.label, f->nirs);
+         ck_assert_msg(f->irbuf[ir->arg1.label].target,
+                       "instruction %d is not a target", ir->arg1.label);
+      }
+   }
+}
+
+START_TEST(test_optim1)
+{
+   input_from_file(TESTDIR "/jit/optim1.vhd");
+
+   parse_check_simplify_and_lower(T_PACKAGE, T_PACK_BODY);
+
+   jit_t *j = jit_new();
+
+   jit_handle_t fold = compile_for_test(j, "WORK.OPTIM1.FOLD(I)I");
+   ck_assert_int_eq(jit_call(j, fold, NULL, 5).integer, 7);
+   ck_assert_int_eq(jit_call(j, fold, NULL, -2).integer, 0);
+
+   {
+      jit_func_t *f = jit_get_func(j, fold);
+      ck_assert_int_eq(count_ops(f, J_STORE), 0);   // Never loaded
+      ck_assert_int_eq(count_ops(f, J_RECV), 1);    // Context unused
+      ck_assert_int_eq(count_insns(f), 10);
+      check_labels(f);
+   }
+
+   jit_handle_t branch = compile_for_test(j, "WORK.OPTIM1.BRANCH(I)I");
+   ck_assert_int_eq(jit_call(j, branch, NULL, 5).integer, 5);
+   ck_assert_int_eq(jit_call(j, branch, NULL, 11).integer, 22);
+   ck_assert_int_eq(jit_call(j, branch, NULL, -3).integer, -3);
+
+   {
+      jit_func_t *f = jit_get_func(j, branch);
+      ck_assert_int_eq(count_ops(f, J_NEG), 0);   // Unreachable
+      ck_assert_int_eq(count_ops(f, J_RECV), 1);
+      check_labels(f);
+   }
+
+   jit_handle_t locals = compile_for_test(j, "WORK.OPTIM1.LOCALS(I)I");
+   ck_assert_int_eq(jit_call(j, locals, NULL, 0).integer, 2);
+   ck_assert_int_eq(jit_call(j, locals, NULL, 10).integer, 42);
+   ck_assert_int_eq(jit_call(j, locals, NULL, -7).integer, -26);
+
+   {
+      jit_func_t *f = jit_get_func(j, locals);
+      ck_assert_int_eq(count_ops(f, J_STORE), 0);   // All forwarded
+      ck_assert_int_eq(count_ops(f, J_LOAD), 0);
+      ck_assert_int_eq(count_insns(f), 21);
+      check_labels(f);
+   }
+
+   jit_handle_t loops = compile_for_test(j, "WORK.OPTIM1.LOOPS(I)I");
+   ck_assert_int_eq(jit_call(j, loops, NULL, 0).integer, 0);
+   ck_assert_int_eq(jit_call(j, loops, NULL, 10).integer, 55);
+   ck_assert_int_eq(jit_call(j, loops, NULL, 100).integer, 1035);
+
+   check_labels(jit_get_func(j, loops));
+
+   jit_free(j);
+
+   fail_if_errors();
+}
+END_TEST
+
+static jit_value_t test_reg(jit_reg_t reg)
+{
+   return (jit_value_t){ .kind = JIT_VALUE_REG, .reg = reg };
+}
+
+static jit_value_t test_int(int64_t value)
+{
+   return (jit_value_t){ .kind = JIT_VALUE_INT64, .int64 = value };
+}
+
+static jit_value_t test_label(jit_label_t label)
+{
+   return (jit_value_t){ .kind = JIT_VALUE_LABEL, .label = label };
+}
+
+START_TEST(test_optim2)
+{
+   // Hand written IR where the first instruction of a loop header is
+   // deleted and a constant condition is folded away
+   const jit_reg_t none = JIT_REG_INVALID;
+   jit_ir_t irbuf[] = {
+      { J_RECV, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, 0, test_int(0) },
+      { J_MOV, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, 1, test_int(5) },
+      { J_MUL, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, 2, test_reg(1), test_int(3) },
+      { J_CMP, JIT_SZ_UNSPEC, 0, JIT_CC_EQ, none, test_reg(2), test_int(15) },
+      { J_JUMP, JIT_SZ_UNSPEC, 0, JIT_CC_F, none, test_label(13) },
+      { J_MOV, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, 3, test_int(0) },
+      { J_MOV, JIT_SZ_UNSPEC, 1, JIT_CC_NONE, 4, test_int(42) },   // Dead
+      { J_ADD, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, 3, test_reg(3), test_reg(0) },
+      { J_SUB, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, 0, test_reg(0), test_int(1) },
+      { J_CMP, JIT_SZ_UNSPEC, 0, JIT_CC_GT, none, test_reg(0), test_int(0) },
+      { J_JUMP, JIT_SZ_UNSPEC, 0, JIT_CC_T, none, test_label(6) },
+      { J_SEND, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, none, test_int(0),
+        test_reg(3) },
+      { J_RET, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, none },
+      { J_SEND, JIT_SZ_UNSPEC, 1, JIT_CC_NONE, none, test_int(0),
+        test_int(-1) },
+      { J_RET, JIT_SZ_UNSPEC, 0, JIT_CC_NONE, none },
+   };
+
+   jit_func_t f = {
+      .irbuf = irbuf,
+      .nirs  = ARRAY_LEN(irbuf),
+      .nregs = 5,
+   };
+
+   jit_optimise(&f);
+
+   ck_assert_int_eq(f.nirs, 8);
+   ck_assert_int_eq(count_ops(&f, J_MUL), 0);
+   ck_assert_int_eq(count_ops(&f, J_CMP), 1);
+   check_labels(&f);
+
+   ck_assert_int_eq(irbuf[2].op, J_ADD);
+   ck_assert(irbuf[2].target);
+   ck_assert_int_eq(irbuf[5].op, J_JUMP);
+   ck_assert_int_eq(irbuf[5].arg1.label, 2);
+
+   jit_free_cfg(&f);
+}
+END_TEST
+
+static int tier_up_count = 0;
+static int tier_up_thread = -1;
+
+static void *stub_tier_init(void)
+{
+   return &tier_up_count;
+}
+
+static void stub_tier_cgen(jit_t *j, jit_handle_t handle, void *context)
+{
+   ck_assert_ptr_eq(context, &tier_up_count);
+   ck_assert_str_eq(istr(jit_get_name(j, handle)), "WORK.PACK.FACT(I)I");
+
+   atomic_store(&tier_up_thread, thread_id());
+   atomic_add(&tier_up_count, 1);
+}
+
+static void stub_tier_cleanup(void *context)
+{
+   ck_assert_ptr_eq(context, &tier_up_count);
+}
+
+START_TEST(test_dispatch)
+{
+   input_from_file(TESTDIR "/jit/fact.vhd");
+
+   const error_t expect[] = {
+      { 10, "result of 479001600 * 13 cannot be represented as INTEGER" },
+      { 10, "result of 479001600 * 13 cannot be represented as INTEGER" },
+      { -1, NULL },
+   };
+   expect_errors(expect);
+
+   parse_check_simplify_and_lower(T_PACKAGE, T_PACK_BODY);
+
+   // The switch-based and direct-threaded interpreters must agree
+   for (int threaded = 0; threaded < 2; threaded++) {
+      jit_t *j = jit_new();
+      jit_enable_threading(j, threaded);
+
+      jit_handle_t fn1 = compile_for_test(j, "WORK.PACK.FACT(I)I");
+      jit_handle_t fn2 = compile_for_test(j, "WORK.PACK.FACT_RECUR(I)I");
+
+      int64_t expect = 1;
+      for (int n = 1; n <= 12; n++) {
+         expect *= n;
+         ck_assert_int_eq(jit_call(j, fn1, NULL, n).integer, expect);
+         ck_assert_int_eq(jit_call(j, fn2, NULL, n).integer, expect);
+      }
+
+      jit_scalar_t result;
+      fail_if(jit_try_call(j, fn1, &result, NULL, 13));
+
+      jit_free(j);
+   }
+}
+END_TEST
+
+START_TEST(test_tierup)
+{
+   input_from_file(TESTDIR "/jit/fact.vhd");
+
+   parse_check_simplify_and_lower(T_PACKAGE, T_PACK_BODY);
+
+   jit_t *j = jit_new();
+
+   const jit_plugin_t stub = {
+      .init    = stub_tier_init,
+      .cgen    = stub_tier_cgen,
+      .cleanup = stub_tier_cleanup,
+   };
+   jit_add_tier(j, 5, &stub);
+
+   jit_handle_t fn = compile_for_test(j, "WORK.PACK.FACT(I)I");
+   for (int i = 0; i < 20; i++)
+      ck_assert_int_eq(jit_call(j, fn, NULL, 5).integer, 120);
+
+   // Compilation happens asynchronously on another thread
+   for (int i = 0; i < 5000 && atomic_load(&tier_up_count) == 0; i++)
+      usleep(1000);
+
+   ck_assert_int_eq(atomic_load(&tier_up_count), 1);
+   ck_assert_int_ne(atomic_load(&tier_up_thread), thread_id());
+
+   // Stub does not replace the entry point so still interpreted
+   ck_assert_int_eq(jit_call(j, fn, NULL, 8).integer, 40320);
+
+   jit_free(j);
+
+   ck_assert_int_eq(tier_up_count, 1);
+
+   fail_if_errors();
+}
+END_TEST
+
+#ifdef LLVM_HAS_LLJIT
+static jit_osr_fn_t real_osr_entry = NULL;
+static int osr_count = 0;
+
+static bool wrap_osr_entry(jit_func_t *f, jit_scalar_t *args,
+                           jit_osr_state_t *state)
+{
+   ck_assert_int_gt(state->target, 0);
+   osr_count++;
+   return (*real_osr_entry)(f, args, state);
+}
+
+static int32_t churn(int32_t n)
+{
+   int32_t v[4] = {}, s = 0;
+   for (int32_t i = 1; i <= n; i++) {
+      if ((v[0] = v[1] + v[3] + 1) > 997)
+         v[0] -= 997;
+      v[1] = v[2];
+      v[2] = v[0];
+      if ((v[3] += 3) > 500)
+         v[3] -= 499;
+      if ((s += v[1]) > 1000000)
+         s -= 999983;
+   }
+   return s + v[2];
+}
+
+START_TEST(test_osr1)
+{
+   input_from_file(TESTDIR "/jit/osr1.vhd");
+
+   parse_check_simplify_and_lower(T_PACKAGE, T_PACK_BODY);
+
+   jit_t *j = jit_new();
+
+   extern const jit_plugin_t jit_llvm;
+   jit_add_tier(j, 10, &jit_llvm);
+
+   jit_handle_t fn = compile_for_test(j, "WORK.OSR1.CHURN(I)I");
+   ck_assert_int_eq(jit_call(j, fn, NULL, 100).integer, churn(100));
+
+   // Compilation happens asynchronously on another thread
+   jit_func_t *f = jit_get_func(j, fn);
+   for (int i = 0; i < 5000 && atomic_load(&f->osr_entry) == NULL; i++)
+      usleep(1000);
+
+   real_osr_entry = atomic_load(&f->osr_entry);
+   ck_assert_ptr_nonnull(real_osr_entry);
+
+   jit_entry_fn_t compiled = atomic_load(&f->entry);
+   ck_assert_ptr_ne(compiled, jit_interp);
+
+   // Start the call in the interpreter so it enters the compiled code
+   // at the first loop back edge
+   atomic_store(&f->osr_entry, wrap_osr_entry);
+
+   for (int threaded = 0; threaded < 2; threaded++) {
+      jit_enable_threading(j, threaded);
+      atomic_store(&f->entry, jit_interp);
+
+      osr_count = 0;
+      ck_assert_int_eq(jit_call(j, fn, NULL, 1000000).integer,
+                       churn(1000000));
+      ck_assert_int_eq(osr_count, 1);
+   }
+
+   atomic_store(&f->entry, compiled);
+   ck_assert_int_eq(jit_call(j, fn, NULL, 12345).integer, churn(12345));
+
+   jit_free(j);
+
+   fail_if_errors();
+}
+END_TEST
+#endif  // LLVM_HAS_LLJIT
+
 Suite *get_jit_tests(void)
 {
    Suite *s = suite_create("jit");
@@ -1188,6 +1512,13 @@ Suite *get_jit_tests(void)
    tcase_add_test(tc, test_process1);
    tcase_add_test(tc, test_value1);
    tcase_add_test(tc, test_ffi1);
+   tcase_add_test(tc, test_optim1);
+   tcase_add_test(tc, test_optim2);
+   tcase_add_test(tc, test_tierup);
+   tcase_add_test(tc, test_dispatch);
+#ifdef LLVM_HAS_LLJIT
+   tcase_add_test(tc, test_osr1);
+#endif
    suite_add_tcase(s, tc);
 
    return s;
@@ -20,6 +20,7 @@
 #include "mask.h"
 #include "ident.h"
 #include "rt/heap.h"
+#include "rt/wheel.h"
 #include "thread.h"
 
 #include <assert.h>
@@ -266,6 +267,136 @@ START_TEST(test_heap_rand)
 }
 END_TEST
 
+START_TEST(test_wheel_basic)
+{
+   wheel_t *w = wheel_new(4);
+
+   wheel_insert(w, 5, (void*)1);
+   wheel_insert(w, 1000000, (void*)2);
+   wheel_insert(w, 5, (void*)3);
+   wheel_insert(w, 2, (void*)4);
+   wheel_insert(w, 12, (void*)5);
+
+   fail_unless(wheel_size(w) == 5);
+
+   uint64_t when;
+   fail_unless(wheel_peek(w, &when));
+   ck_assert_int_eq(when, 2);
+
+   void **batch;
+   ck_assert_int_eq(wheel_pop(w, &when, &batch), 1);
+   ck_assert_int_eq(when, 2);
+   fail_unless(batch[0] == (void*)4);
+
+   ck_assert_int_eq(wheel_pop(w, &when, &batch), 2);
+   ck_assert_int_eq(when, 5);
+   fail_unless(batch[0] == (void*)1);
+   fail_unless(batch[1] == (void*)3);
+
+   wheel_insert(w, 12, (void*)6);
+
+   ck_assert_int_eq(wheel_pop(w, &when, &batch), 2);
+   ck_assert_int_eq(when, 12);
+   fail_unless(batch[0] == (void*)5);
+   fail_unless(batch[1] == (void*)6);
+
+   fail_unless(wheel_peek(w, &when));
+   ck_assert_int_eq(when, 1000000);
+
+   ck_assert_int_eq(wheel_pop(w, &when, &batch), 1);
+   ck_assert_int_eq(when, 1000000);
+   fail_unless(batch[0] == (void*)2);
+
+   fail_unless(wheel_size(w) == 0);
+   fail_if(wheel_peek(w, &when));
+   ck_assert_int_eq(wheel_pop(w, &when, &batch), 0);
+
+   wheel_free(w);
+}
+END_TEST
+
+START_TEST(test_wheel_cancel)
+{
+   wheel_t *w = wheel_new(4);
+
+   wheel_node_t *n1 = wheel_insert(w, 10, (void*)1);
+   wheel_insert(w, 10, (void*)2);
+   wheel_node_t *n3 = wheel_insert(w, 1000000, (void*)3);
+   wheel_insert(w, 2000000, (void*)4);
+   wheel_node_t *n5 = wheel_insert(w, 20, (void*)5);
+
+   wheel_cancel(w, n1);
+   wheel_cancel(w, n3);
+   wheel_cancel(w, n5);
+
+   fail_unless(wheel_size(w) == 2);
+
+   uint64_t when;
+   void **batch;
+   ck_assert_int_eq(wheel_pop(w, &when, &batch), 1);
+   ck_assert_int_eq(when, 10);
+   fail_unless(batch[0] == (void*)2);
+
+   ck_assert_int_eq(wheel_pop(w, &when, &batch), 1);
+   ck_assert_int_eq(when, 2000000);
+   fail_unless(batch[0] == (void*)4);
+
+   fail_if(wheel_peek(w, &when));
+
+   wheel_free(w);
+}
+END_TEST
+
+START_TEST(test_wheel_rand)
+{
+   wheel_t *w = wheel_new(4);
+
+   static const int N = 4096;
+   uint64_t now = 0;
+   int pending = 0, popped = 0;
+
+   for (int i = 0; i < N; i++) {
+      const uint64_t delay = (rand() % 4 == 0) ? rand() % 1000000 : rand() % 64;
+      wheel_insert(w, now + delay, (void*)(uintptr_t)(now + delay));
+      pending++;
+
+      if (rand() % 3 == 0) {
+         uint64_t when;
+         void **batch;
+         const size_t nbatch = wheel_pop(w, &when, &batch);
+         fail_unless(nbatch > 0);
+         fail_unless(when >= now);
+
+         for (size_t j = 0; j < nbatch; j++)
+            fail_unless(batch[j] == (void*)(uintptr_t)when);
+
+         now = when;
+         pending -= nbatch;
+         popped += nbatch;
+      }
+   }
+
+   ck_assert_int_eq(wheel_size(w), pending);
+
+   uint64_t when;
+   void **batch;
+   size_t nbatch;
+   while ((nbatch = wheel_pop(w, &when, &batch)) > 0) {
+      fail_unless(when >= now);
+      for (size_t j = 0; j < nbatch; j++)
+         fail_unless(batch[j] == (void*)(uintptr_t)when);
+
+      now = when;
+      popped += nbatch;
+   }
+
+   ck_assert_int_eq(popped, N);
+   ck_assert_int_eq(wheel_size(w), 0);
+
+   wheel_free(w);
+}
+END_TEST
+
 START_TEST(test_color_printf)
 {
    setenv("NVC_COLORS", "always", 1);
@@ -470,6 +601,40 @@ START_TEST(test_threads)
 }
 END_TEST
 
+static nvc_sema_t sema_items = 0;
+static int        sema_taken = 0;
+
+static void *sema_consumer_fn(void *__arg)
+{
+   for (;;) {
+      nvc_sema_wait(&sema_items);
+      if (atomic_add(&sema_taken, 1) > 1000)
+         return NULL;
+   }
+}
+
+START_TEST(test_sema)
+{
+   static const int N = 3;
+   nvc_thread_t *threads[N];
+   for (int i = 0; i < N; i++)
+      threads[i] = thread_create(sema_consumer_fn, NULL, "s%d", i);
+
+   for (int i = 0; i < 1000; i++)
+      nvc_sema_post(&sema_items);
+
+   // One extra post per consumer to make each of them exit
+   for (int i = 0; i < N; i++)
+      nvc_sema_post(&sema_items);
+
+   for (int i = 0; i < N; i++)
+      thread_join(threads[i]);
+
+   ck_assert_int_eq(sema_taken, 1000 + N);
+   ck_assert_int_eq(sema_items, 0);
+}
+END_TEST
+
 Suite *get_misc_tests(void)
 {
    Suite *s = suite_create("misc");
@@ -494,6 +659,12 @@ Suite *get_misc_tests(void)
    tcase_add_test(tc_heap, test_heap_walk);
    suite_add_tcase(s, tc_heap);
 
+   TCase *tc_wheel = tcase_create("wheel");
+   tcase_add_test(tc_wheel, test_wheel_basic);
+   tcase_add_test(tc_wheel, test_wheel_cancel);
+   tcase_add_test(tc_wheel, test_wheel_rand);
+   suite_add_tcase(s, tc_wheel);
+
    TCase *tc_util = tcase_create("util");
    tcase_add_test(tc_util, test_color_printf);
    suite_add_tcase(s, tc_util);
@@ -508,6 +679,7 @@ Suite *get_misc_tests(void)
 
    TCase *tc_thread = tcase_create("thread");
    tcase_add_test(tc_heap, test_threads);
+   tcase_add_test(tc_thread, test_sema);
    suite_add_tcase(s, tc_thread);
 
    return s;
@@ -109,18 +109,23 @@ START_TEST(test_index1)
    ck_assert_int_eq(ss1->n_nexus, 21);
    ck_assert_int_eq(ss1->nexus.width, 8);
    ck_assert_ptr_nonnull(ss1->index);
-   ck_assert_int_eq(ss1->index->how, 3);
-   ck_assert_ptr_eq(ss1->index->nexus[0], &(ss1->nexus));
-   ck_assert_ptr_nonnull(ss1->index->nexus[20]);
-   ck_assert_ptr_null(ss1->index->nexus[21]);
+   ck_assert_int_eq(ss1->index->nleaves, 13);
+   ck_assert_int_eq(ss1->index->nlevels, 1);
+   ck_assert_int_eq(ss1->index->summary[0][0], 0x7);
+   ck_assert_int_eq(ss1->index->leaves[0].map, 0x0101010101010101);
+   ck_assert_ptr_eq(ss1->index->leaves[0].nexus[0], &(ss1->nexus));
+   ck_assert_int_eq(ss1->index->leaves[2].map, 0x101010101);
+   ck_assert_int_eq(ss1->index->leaves[2].nexus[4]->width, 640);
+   ck_assert_int_eq(ss1->index->leaves[3].map, 0);
 
    ck_assert_int_eq(ss2->n_nexus, 41);
    ck_assert_int_eq(ss2->nexus.width, 10);
    ck_assert_ptr_nonnull(ss2->index);
-   ck_assert_int_eq(ss2->index->how, -10);
-   ck_assert_ptr_eq(ss2->index->nexus[0], &(ss2->nexus));
-   ck_assert_ptr_nonnull(ss2->index->nexus[40]);
-   ck_assert_ptr_null(ss2->index->nexus[41]);
+   ck_assert_int_eq(ss2->index->nleaves, 8);
+   ck_assert_int_eq(ss2->index->summary[0][0], 0x7f);
+   ck_assert_int_eq(ss2->index->leaves[0].map, 0x1004010040100401);
+   ck_assert_ptr_eq(ss2->index->leaves[0].nexus[0], &(ss2->nexus));
+   ck_assert_int_eq(ss2->index->leaves[7].map, 0);
 
    model_free(m);
    jit_free(j);
@@ -1380,6 +1380,32 @@ START_TEST(test_casefold1)
 }
 END_TEST
 
+START_TEST(test_wait1)
+{
+   input_from_file(TESTDIR "/simp/wait1.vhd");
+
+   tree_t a = parse_check_and_simplify(T_ENTITY, T_ARCH);
+
+   static const bool expect[] = { true, false, false, false, false };
+
+   fail_unless(tree_stmts(a) == ARRAY_LEN(expect));
+
+   for (int i = 0; i < ARRAY_LEN(expect); i++) {
+      tree_t p = tree_stmt(a, i);
+      fail_unless(tree_kind(p) == T_PROCESS);
+
+      tree_t w = tree_stmt(p, tree_stmts(p) - 1);
+      fail_unless(tree_kind(w) == T_WAIT);
+
+      const bool is_static = !!(tree_flags(w) & TREE_F_STATIC_WAIT);
+      ck_assert_msg(is_static == expect[i], "process %s",
+                    istr(tree_ident(p)));
+   }
+
+   fail_if_errors();
+}
+END_TEST
+
 Suite *get_simp_tests(void)
 {
    Suite *s = suite_create("simplify");
@@ -1434,6 +1460,7 @@ Suite *get_simp_tests(void)
    tcase_add_test(tc_core, test_issue496);
    tcase_add_test(tc_core, test_genpack1);
    tcase_add_test(tc_core, test_casefold1);
+   tcase_add_test(tc_core, test_wait1);
    suite_add_tcase(s, tc_core);
 
    return s;
@@ -86,6 +86,10 @@ static void setup(void)
    opt_set_int(OPT_RT_TRACE, 0);
    opt_set_int(OPT_STOP_DELTA, 1000);
    opt_set_int(OPT_RT_STATS, 0);
+   opt_set_str(OPT_RT_PROFILE, NULL);
+   opt_set_int(OPT_RT_PARALLEL, 0);
+   opt_set_int(OPT_RT_LEVELISE, 0);
+   opt_set_int(OPT_PERF_MAP, 0);
 
    intern_strings();
 }
@@ -0,0 +1,115 @@
+#include "vhpi_user.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define fail_if(x)                                                      \
+   if (x) vhpi_assert(vhpiFailure, "assertion '%s' failed at %s:%d",    \
+                      #x, __FILE__, __LINE__)
+#define fail_unless(x) fail_if(!(x))
+
+static vhpiHandleT handle_last;
+static int         nchanges = 0;
+
+static void check_error(void)
+{
+   vhpiErrorInfoT info;
+   if (vhpi_check_error(&info))
+      vhpi_assert(vhpiFailure, "unexpected error '%s'", info.message);
+}
+
+static int get_last(void)
+{
+   vhpiValueT value = {
+      .format = vhpiObjTypeVal
+   };
+   vhpi_get_value(handle_last, &value);
+   check_error();
+   fail_unless(value.format == vhpiIntVal);
+
+   return value.value.intg;
+}
+
+static void last_value_change(const vhpiCbDataT *cb_data)
+{
+   const int last = get_last();
+   vhpi_printf("last value changed to %d", last);
+
+   fail_unless(last == 5);
+   nchanges++;
+}
+
+static void after_3ns(const vhpiCbDataT *cb_data)
+{
+   // Nothing has observed LAST until now so its value may be stale
+   const int last = get_last();
+   vhpi_printf("last is %d after 3ns", last);
+   fail_unless(last == 2);
+
+   vhpiCbDataT cb_data2 = {
+      .reason = vhpiCbValueChange,
+      .cb_rtn = last_value_change,
+      .obj    = handle_last
+   };
+   vhpi_register_cb(&cb_data2, 0);
+   check_error();
+}
+
+static void start_of_sim(const vhpiCbDataT *cb_data)
+{
+   fail_unless(get_last() == 0);
+
+   vhpiTimeT time_3ns = {
+      .low = 3000000
+   };
+
+   vhpiCbDataT cb_data2 = {
+      .reason = vhpiCbAfterDelay,
+      .cb_rtn = after_3ns,
+      .time   = &time_3ns
+   };
+   vhpi_register_cb(&cb_data2, 0);
+   check_error();
+}
+
+static void end_of_sim(const vhpiCbDataT *cb_data)
+{
+   fail_unless(get_last() == 5);
+   fail_unless(nchanges == 1);
+
+   vhpi_release_handle(handle_last);
+}
+
+static void startup()
+{
+   vhpiCbDataT cb_data1 = {
+      .reason = vhpiCbStartOfSimulation,
+      .cb_rtn = start_of_sim,
+   };
+   vhpi_register_cb(&cb_data1, 0);
+   check_error();
+
+   vhpiCbDataT cb_data2 = {
+      .reason = vhpiCbEndOfSimulation,
+      .cb_rtn = end_of_sim
+   };
+   vhpi_register_cb(&cb_data2, 0);
+   check_error();
+
+   vhpiHandleT root = vhpi_handle(vhpiRootInst, NULL);
+   check_error();
+   fail_if(root == NULL);
+
+   handle_last = vhpi_handle_by_name("last", root);
+   check_error();
+   fail_if(handle_last == NULL);
+
+   vhpi_release_handle(root);
+}
+
+void (*vhpi_startup_routines[])() = {
+   startup,
+   NULL
+};